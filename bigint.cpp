@@ -1,21 +1,5516 @@
 //-lgmp -funroll-loops -ffast-math -O3 -march=native -mtune=native -pipe -flto -fwhole-program -fwhole-file -fomit-frame-pointer -faggressive-loop-optimizations
 #include <bits/stdc++.h>
+#if defined(__unix__) || defined(__APPLE__)
+#define BIGINT_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define BIGINT_HAVE_MMAP 0
+#endif
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(BIGINT_NO_ASM)
+#define BIGINT_X86_64_ASM 1
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define BIGINT_X86_64_ASM 0
+#endif
 using namespace std;
+namespace CBigInt
+{
+
+// This code is a C implementation of a BigInt library using u64
+// to represent large integers. It includes functions for
+// initialization, addition, multiplication, division, and printing
+// as string. It also includes a function to convert a string
+// representation of a number into a BigInt. The library is
+// designed to handle very large integers that cannot be
+// represented by standard data types like int or long long.
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <inttypes.h>
+#include <math.h>
+
+#define CHUNK_BASE 10000000000000000000ULL // largest power of ten in a limb
+#define CHUNK_DIGITS 19
+#define BASE 10
+
+	typedef unsigned long long u64;
+	const u64 MAX_BASE = UINT64_MAX;
+
+// Values up to this many limbs live inside the struct; `limbs` points at
+// `small` until the value outgrows it and is promoted to the heap. A BigInt
+// therefore must not be copied by plain struct assignment: use bigint_copy.
+#define BIGINT_INLINE_LIMBS 2
+
+	typedef struct
+	{
+		u64 *limbs;
+		int size;
+		int capacity;
+		int sign;
+		u64 small[BIGINT_INLINE_LIMBS];
+	} BigInt;
+
+	// ---------- Memory Helpers ----------
+	static inline int bigint_is_inline(const BigInt *num)
+	{
+		return num->limbs == num->small;
+	}
+
+	void bigint_reserve(BigInt *num, int required)
+	{
+		if (required <= num->capacity)
+			return;
+
+		int new_cap = (num->capacity > 0) ? num->capacity * 2 : 4;
+		while (new_cap < required)
+			new_cap *= 2;
+
+		u64 *limbs = (u64 *)realloc(bigint_is_inline(num) ? NULL : num->limbs, new_cap * sizeof(u64));
+		if (!limbs)
+		{
+			fprintf(stderr, "Memory allocation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		if (bigint_is_inline(num))
+			memcpy(limbs, num->small, num->capacity * sizeof(u64));
+		num->limbs = limbs;
+		memset(num->limbs + num->capacity, 0, (new_cap - num->capacity) * sizeof(u64));
+		num->capacity = new_cap;
+	}
+
+	void bigint_free(BigInt *num)
+	{
+		if (!bigint_is_inline(num))
+			free(num->limbs);
+		// Left as a valid empty value on its inline storage
+		memset(num->small, 0, sizeof(num->small));
+		num->limbs = num->small;
+		num->size = 0;
+		num->capacity = BIGINT_INLINE_LIMBS;
+		num->sign = 0;
+	}
+
+	void bigint_copy(BigInt *dst, const BigInt *src)
+	{
+		bigint_reserve(dst, src->size);
+		memcpy(dst->limbs, src->limbs, src->size * sizeof(u64));
+		dst->size = src->size;
+		dst->sign = src->sign;
+	}
+
+	// Exchanges two values; heap storage changes hands without copying
+	void bigint_swap(BigInt *a, BigInt *b)
+	{
+		int a_inline = bigint_is_inline(a), b_inline = bigint_is_inline(b);
+		BigInt t = *a;
+		*a = *b;
+		*b = t;
+		if (b_inline)
+			a->limbs = a->small;
+		if (a_inline)
+			b->limbs = b->small;
+	}
+
+	// ---------- Scratch Arena ----------
+	// Internal temporaries come from a per-thread bump-pointer arena instead of
+	// malloc. Every routine takes a mark on entry and releases back to it on
+	// exit, so the arena is empty again between public operations. Blocks are
+	// chained when the current one is full; the largest released block is kept
+	// as a spare, so a steady workload stops allocating after its first call.
+	// Batch jobs can install their own arena, optionally over a caller buffer.
+#define ARENA_MIN_LIMBS 4096
+
+	typedef struct BigIntArenaBlock
+	{
+		struct BigIntArenaBlock *prev;
+		size_t size; // limbs following the header
+		size_t used;
+		int owned; // allocated by the arena (not a caller buffer)
+	} BigIntArenaBlock;
+
+	typedef struct
+	{
+		BigIntArenaBlock *head;
+		BigIntArenaBlock *spare;
+	} BigIntArena;
+
+	typedef struct
+	{
+		BigIntArenaBlock *block;
+		size_t used;
+	} BigIntArenaMark;
+
+	void bigint_arena_init(BigIntArena *arena, void *buffer, size_t bytes)
+	{
+		arena->head = NULL;
+		arena->spare = NULL;
+		// A caller buffer becomes the bottom block, after 8-byte alignment
+		uintptr_t start = ((uintptr_t)buffer + 7) & ~(uintptr_t)7;
+		if (buffer && start + sizeof(BigIntArenaBlock) <= (uintptr_t)buffer + bytes)
+		{
+			BigIntArenaBlock *block = (BigIntArenaBlock *)start;
+			block->prev = NULL;
+			block->size = ((uintptr_t)buffer + bytes - start - sizeof(BigIntArenaBlock)) / sizeof(u64);
+			block->used = 0;
+			block->owned = 0;
+			arena->head = block;
+		}
+	}
+
+	void bigint_arena_free(BigIntArena *arena)
+	{
+		while (arena->head)
+		{
+			BigIntArenaBlock *block = arena->head;
+			arena->head = block->prev;
+			if (block->owned)
+				free(block);
+		}
+		free(arena->spare);
+		arena->spare = NULL;
+	}
+
+	struct BigIntThreadArena
+	{
+		BigIntArena arena;
+		BigIntArena *current;
+		~BigIntThreadArena() { bigint_arena_free(&arena); }
+	};
+	static thread_local BigIntThreadArena thread_arena = {{NULL, NULL}, NULL};
+
+	// Makes `arena` the one this thread's operations draw from (NULL selects
+	// the thread's own) and returns the previously selected arena.
+	BigIntArena *bigint_arena_use(BigIntArena *arena)
+	{
+		BigIntArena *prev = thread_arena.current ? thread_arena.current : &thread_arena.arena;
+		thread_arena.current = arena;
+		return prev;
+	}
+
+	static inline BigIntArena *scratch_arena(void)
+	{
+		return thread_arena.current ? thread_arena.current : &thread_arena.arena;
+	}
+
+	static BigIntArenaMark scratch_mark(void)
+	{
+		BigIntArena *arena = scratch_arena();
+		BigIntArenaMark mark = {arena->head, arena->head ? arena->head->used : 0};
+		return mark;
+	}
+
+	static u64 *scratch_alloc(size_t n)
+	{
+		BigIntArena *arena = scratch_arena();
+		BigIntArenaBlock *head = arena->head;
+		if (n == 0)
+			n = 1;
+		if (!head || head->size - head->used < n)
+		{
+			BigIntArenaBlock *block = arena->spare;
+			if (block && block->size >= n)
+				arena->spare = NULL;
+			else
+			{
+				size_t size = head ? 2 * head->size : ARENA_MIN_LIMBS;
+				if (size < n)
+					size = n;
+				block = (BigIntArenaBlock *)malloc(sizeof(BigIntArenaBlock) + size * sizeof(u64));
+				if (!block)
+				{
+					fprintf(stderr, "Memory allocation failed\n");
+					exit(EXIT_FAILURE);
+				}
+				block->size = size;
+				block->owned = 1;
+			}
+			block->prev = head;
+			block->used = 0;
+			arena->head = head = block;
+		}
+		u64 *p = (u64 *)(head + 1) + head->used;
+		head->used += n;
+		return p;
+	}
+
+	static void scratch_release(BigIntArenaMark mark)
+	{
+		BigIntArena *arena = scratch_arena();
+		while (arena->head != mark.block)
+		{
+			BigIntArenaBlock *block = arena->head;
+			arena->head = block->prev;
+			if (!block->owned)
+				continue;
+			if (!arena->spare || arena->spare->size < block->size)
+			{
+				free(arena->spare);
+				arena->spare = block;
+			}
+			else
+				free(block);
+		}
+		if (arena->head)
+			arena->head->used = mark.used;
+	}
+
+	// ---------- Limb Kernels ----------
+	// Little-endian limb arrays in the style of GMP's mpn layer. Sizes are
+	// limb counts, carries and borrows are returned instead of stored, and the
+	// output may be the same array as an input (rp == ap, or rp == bp for the
+	// two-operand kernels) so every kernel also works in place. Other partial
+	// overlaps are not supported. Everything above this layer is built on it.
+
+	// rp[0..n) = ap + bp, returns the carry out
+	static u64 limbs_add_n_generic(u64 *rp, const u64 *ap, const u64 *bp, int n)
+	{
+		u64 carry = 0;
+		for (int i = 0; i < n; i++)
+		{
+			__uint128_t sum = (__uint128_t)ap[i] + bp[i] + carry;
+			rp[i] = (u64)sum;
+			carry = (u64)(sum >> 64);
+		}
+		return carry;
+	}
+
+	// rp[0..n) = ap - bp, returns the borrow out
+	static u64 limbs_sub_n_generic(u64 *rp, const u64 *ap, const u64 *bp, int n)
+	{
+		u64 borrow = 0;
+		for (int i = 0; i < n; i++)
+		{
+			u64 x = ap[i], y = bp[i];
+			rp[i] = x - y - borrow;
+			borrow = (x < y) || (x == y && borrow);
+		}
+		return borrow;
+	}
+
+	// rp[0..n) = ap * b + carry, returns the high limb
+	static u64 limbs_mul_1c_generic(u64 *rp, const u64 *ap, int n, u64 b, u64 carry)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			__uint128_t prod = (__uint128_t)ap[i] * b + carry;
+			rp[i] = (u64)prod;
+			carry = (u64)(prod >> 64);
+		}
+		return carry;
+	}
+
+	// rp[0..n) += ap * b, returns the limb carried out of the top.
+	// rp must not overlap ap.
+	static u64 limbs_addmul_1_generic(u64 *rp, const u64 *ap, int n, u64 b)
+	{
+		u64 carry = 0;
+		for (int i = 0; i < n; i++)
+		{
+			__uint128_t prod = (__uint128_t)ap[i] * b + rp[i] + carry;
+			rp[i] = (u64)prod;
+			carry = (u64)(prod >> 64);
+		}
+		return carry;
+	}
+
+	// rp[0..n) -= ap * b, returns the limb borrowed out of the top.
+	// rp must not overlap ap.
+	static u64 limbs_submul_1_generic(u64 *rp, const u64 *ap, int n, u64 b)
+	{
+		u64 borrow = 0;
+		for (int i = 0; i < n; i++)
+		{
+			__uint128_t prod = (__uint128_t)ap[i] * b + borrow;
+			u64 lo = (u64)prod;
+			borrow = (u64)(prod >> 64) + (rp[i] < lo);
+			rp[i] -= lo;
+		}
+		return borrow;
+	}
+
+#if BIGINT_X86_64_ASM
+	// ---- x86-64 kernels ----
+	// The loops below run over blocks of four limbs; the n % 4 low limbs go
+	// through the portable kernel first and its carry seeds the assembly.
+	// add_n/sub_n only need adc/sbb and run on every x86-64. The multiply
+	// kernels use mulx (BMI2) with two independent carry chains, adox for
+	// the product high limbs and adcx for the accumulation (ADX). dec would
+	// clobber OF there, so those loops count with lea and jrcxz instead.
+
+	static u64 limbs_add_n_x86(u64 *rp, const u64 *ap, const u64 *bp, int n)
+	{
+		int r = n & 3;
+		u64 carry = limbs_add_n_generic(rp, ap, bp, r);
+		long blocks = n >> 2;
+		if (!blocks)
+			return carry;
+		rp += r, ap += r, bp += r;
+		u64 t0, t1;
+		__asm__ volatile(
+			"neg %[c]\n\t" // CF = carry
+			"1:\n\t"
+			"mov (%[ap]), %[t0]\n\t"
+			"mov 8(%[ap]), %[t1]\n\t"
+			"adc (%[bp]), %[t0]\n\t"
+			"adc 8(%[bp]), %[t1]\n\t"
+			"mov %[t0], (%[rp])\n\t"
+			"mov %[t1], 8(%[rp])\n\t"
+			"mov 16(%[ap]), %[t0]\n\t"
+			"mov 24(%[ap]), %[t1]\n\t"
+			"adc 16(%[bp]), %[t0]\n\t"
+			"adc 24(%[bp]), %[t1]\n\t"
+			"mov %[t0], 16(%[rp])\n\t"
+			"mov %[t1], 24(%[rp])\n\t"
+			"lea 32(%[ap]), %[ap]\n\t"
+			"lea 32(%[bp]), %[bp]\n\t"
+			"lea 32(%[rp]), %[rp]\n\t"
+			"dec %[k]\n\t"
+			"jnz 1b\n\t"
+			"mov $0, %k[c]\n\t"
+			"adc $0, %k[c]\n\t"
+			: [c] "+&r"(carry), [k] "+&r"(blocks), [rp] "+&r"(rp), [ap] "+&r"(ap), [bp] "+&r"(bp),
+			  [t0] "=&r"(t0), [t1] "=&r"(t1)
+			:
+			: "cc", "memory");
+		return carry;
+	}
+
+	static u64 limbs_sub_n_x86(u64 *rp, const u64 *ap, const u64 *bp, int n)
+	{
+		int r = n & 3;
+		u64 borrow = limbs_sub_n_generic(rp, ap, bp, r);
+		long blocks = n >> 2;
+		if (!blocks)
+			return borrow;
+		rp += r, ap += r, bp += r;
+		u64 t0, t1;
+		__asm__ volatile(
+			"neg %[c]\n\t" // CF = borrow
+			"1:\n\t"
+			"mov (%[ap]), %[t0]\n\t"
+			"mov 8(%[ap]), %[t1]\n\t"
+			"sbb (%[bp]), %[t0]\n\t"
+			"sbb 8(%[bp]), %[t1]\n\t"
+			"mov %[t0], (%[rp])\n\t"
+			"mov %[t1], 8(%[rp])\n\t"
+			"mov 16(%[ap]), %[t0]\n\t"
+			"mov 24(%[ap]), %[t1]\n\t"
+			"sbb 16(%[bp]), %[t0]\n\t"
+			"sbb 24(%[bp]), %[t1]\n\t"
+			"mov %[t0], 16(%[rp])\n\t"
+			"mov %[t1], 24(%[rp])\n\t"
+			"lea 32(%[ap]), %[ap]\n\t"
+			"lea 32(%[bp]), %[bp]\n\t"
+			"lea 32(%[rp]), %[rp]\n\t"
+			"dec %[k]\n\t"
+			"jnz 1b\n\t"
+			"mov $0, %k[c]\n\t"
+			"adc $0, %k[c]\n\t"
+			: [c] "+&r"(borrow), [k] "+&r"(blocks), [rp] "+&r"(rp), [ap] "+&r"(ap), [bp] "+&r"(bp),
+			  [t0] "=&r"(t0), [t1] "=&r"(t1)
+			:
+			: "cc", "memory");
+		return borrow;
+	}
+
+	static u64 limbs_mul_1c_adx(u64 *rp, const u64 *ap, int n, u64 b, u64 carry)
+	{
+		int r = n & 3;
+		carry = limbs_mul_1c_generic(rp, ap, r, b, carry);
+		if (n == r)
+			return carry;
+		rp += n, ap += n;
+		long i = r - n;
+		u64 lo0, lo1, hi0;
+		__asm__ volatile(
+			"xor %k[lo0], %k[lo0]\n\t" // CF = 0
+			"1:\n\t"
+			"mulx (%[ap],%[i],8), %[lo0], %[hi0]\n\t"
+			"adcx %[c], %[lo0]\n\t"
+			"mov %[lo0], (%[rp],%[i],8)\n\t"
+			"mulx 8(%[ap],%[i],8), %[lo1], %[c]\n\t"
+			"adcx %[hi0], %[lo1]\n\t"
+			"mov %[lo1], 8(%[rp],%[i],8)\n\t"
+			"mulx 16(%[ap],%[i],8), %[lo0], %[hi0]\n\t"
+			"adcx %[c], %[lo0]\n\t"
+			"mov %[lo0], 16(%[rp],%[i],8)\n\t"
+			"mulx 24(%[ap],%[i],8), %[lo1], %[c]\n\t"
+			"adcx %[hi0], %[lo1]\n\t"
+			"mov %[lo1], 24(%[rp],%[i],8)\n\t"
+			"lea 4(%[i]), %[i]\n\t"
+			"jrcxz 2f\n\t"
+			"jmp 1b\n"
+			"2:\n\t"
+			"mov $0, %k[lo0]\n\t"
+			"adcx %[lo0], %[c]\n\t"
+			: [i] "+c"(i), [c] "+&r"(carry), [lo0] "=&r"(lo0), [lo1] "=&r"(lo1), [hi0] "=&r"(hi0)
+			: [rp] "r"(rp), [ap] "r"(ap), "d"(b)
+			: "cc", "memory");
+		return carry;
+	}
+
+	static u64 limbs_addmul_1_adx(u64 *rp, const u64 *ap, int n, u64 b)
+	{
+		int r = n & 3;
+		u64 carry = limbs_addmul_1_generic(rp, ap, r, b);
+		if (n == r)
+			return carry;
+		rp += n, ap += n;
+		long i = r - n;
+		u64 lo0, lo1, hi0;
+		__asm__ volatile(
+			"xor %k[lo0], %k[lo0]\n\t" // CF = OF = 0
+			"1:\n\t"
+			"mulx (%[ap],%[i],8), %[lo0], %[hi0]\n\t"
+			"adox %[c], %[lo0]\n\t"
+			"adcx (%[rp],%[i],8), %[lo0]\n\t"
+			"mov %[lo0], (%[rp],%[i],8)\n\t"
+			"mulx 8(%[ap],%[i],8), %[lo1], %[c]\n\t"
+			"adox %[hi0], %[lo1]\n\t"
+			"adcx 8(%[rp],%[i],8), %[lo1]\n\t"
+			"mov %[lo1], 8(%[rp],%[i],8)\n\t"
+			"mulx 16(%[ap],%[i],8), %[lo0], %[hi0]\n\t"
+			"adox %[c], %[lo0]\n\t"
+			"adcx 16(%[rp],%[i],8), %[lo0]\n\t"
+			"mov %[lo0], 16(%[rp],%[i],8)\n\t"
+			"mulx 24(%[ap],%[i],8), %[lo1], %[c]\n\t"
+			"adox %[hi0], %[lo1]\n\t"
+			"adcx 24(%[rp],%[i],8), %[lo1]\n\t"
+			"mov %[lo1], 24(%[rp],%[i],8)\n\t"
+			"lea 4(%[i]), %[i]\n\t"
+			"jrcxz 2f\n\t"
+			"jmp 1b\n"
+			"2:\n\t"
+			"mov $0, %k[lo0]\n\t"
+			"adox %[lo0], %[c]\n\t"
+			"adcx %[lo0], %[c]\n\t"
+			: [i] "+c"(i), [c] "+&r"(carry), [lo0] "=&r"(lo0), [lo1] "=&r"(lo1), [hi0] "=&r"(hi0)
+			: [rp] "r"(rp), [ap] "r"(ap), "d"(b)
+			: "cc", "memory");
+		return carry;
+	}
+
+	// Same chains as addmul_1, using r - x = ~(~r + x) so that the
+	// subtraction can ride on adcx as well
+	static u64 limbs_submul_1_adx(u64 *rp, const u64 *ap, int n, u64 b)
+	{
+		int r = n & 3;
+		u64 borrow = limbs_submul_1_generic(rp, ap, r, b);
+		if (n == r)
+			return borrow;
+		rp += n, ap += n;
+		long i = r - n;
+		u64 lo0, lo1, hi0, t;
+		__asm__ volatile(
+			"xor %k[lo0], %k[lo0]\n\t" // CF = OF = 0
+			"1:\n\t"
+			"mulx (%[ap],%[i],8), %[lo0], %[hi0]\n\t"
+			"adox %[c], %[lo0]\n\t"
+			"mov (%[rp],%[i],8), %[t]\n\t"
+			"not %[t]\n\t"
+			"adcx %[lo0], %[t]\n\t"
+			"not %[t]\n\t"
+			"mov %[t], (%[rp],%[i],8)\n\t"
+			"mulx 8(%[ap],%[i],8), %[lo1], %[c]\n\t"
+			"adox %[hi0], %[lo1]\n\t"
+			"mov 8(%[rp],%[i],8), %[t]\n\t"
+			"not %[t]\n\t"
+			"adcx %[lo1], %[t]\n\t"
+			"not %[t]\n\t"
+			"mov %[t], 8(%[rp],%[i],8)\n\t"
+			"mulx 16(%[ap],%[i],8), %[lo0], %[hi0]\n\t"
+			"adox %[c], %[lo0]\n\t"
+			"mov 16(%[rp],%[i],8), %[t]\n\t"
+			"not %[t]\n\t"
+			"adcx %[lo0], %[t]\n\t"
+			"not %[t]\n\t"
+			"mov %[t], 16(%[rp],%[i],8)\n\t"
+			"mulx 24(%[ap],%[i],8), %[lo1], %[c]\n\t"
+			"adox %[hi0], %[lo1]\n\t"
+			"mov 24(%[rp],%[i],8), %[t]\n\t"
+			"not %[t]\n\t"
+			"adcx %[lo1], %[t]\n\t"
+			"not %[t]\n\t"
+			"mov %[t], 24(%[rp],%[i],8)\n\t"
+			"lea 4(%[i]), %[i]\n\t"
+			"jrcxz 2f\n\t"
+			"jmp 1b\n"
+			"2:\n\t"
+			"mov $0, %k[lo0]\n\t"
+			"adox %[lo0], %[c]\n\t"
+			"adcx %[lo0], %[c]\n\t"
+			: [i] "+c"(i), [c] "+&r"(borrow), [lo0] "=&r"(lo0), [lo1] "=&r"(lo1), [hi0] "=&r"(hi0), [t] "=&r"(t)
+			: [rp] "r"(rp), [ap] "r"(ap), "d"(b)
+			: "cc", "memory");
+		return borrow;
+	}
+
+	// BMI2 (mulx) and ADX (adcx/adox): CPUID leaf 7, EBX bits 8 and 19
+	static int cpu_has_adx(void)
+	{
+		unsigned int eax, ebx, ecx, edx;
+		if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+			return 0;
+		return (ebx >> 8 & 1) && (ebx >> 19 & 1);
+	}
+#endif
+
+	// ---- Kernel dispatch ----
+	// The hot kernels are called through this table. It starts out on the
+	// portable versions and is switched to the best set the CPU supports
+	// during static initialization, so one binary serves every host.
+	typedef struct
+	{
+		u64 (*add_n)(u64 *, const u64 *, const u64 *, int);
+		u64 (*sub_n)(u64 *, const u64 *, const u64 *, int);
+		u64 (*mul_1c)(u64 *, const u64 *, int, u64, u64);
+		u64 (*addmul_1)(u64 *, const u64 *, int, u64);
+		u64 (*submul_1)(u64 *, const u64 *, int, u64);
+		const char *name;
+	} LimbKernels;
+
+	static LimbKernels limb_kernels = {limbs_add_n_generic, limbs_sub_n_generic, limbs_mul_1c_generic,
+									   limbs_addmul_1_generic, limbs_submul_1_generic, "generic"};
+
+	static int limbs_select_kernels(void)
+	{
+#if BIGINT_X86_64_ASM
+		limb_kernels.add_n = limbs_add_n_x86;
+		limb_kernels.sub_n = limbs_sub_n_x86;
+		limb_kernels.name = "x86-64";
+		if (cpu_has_adx())
+		{
+			limb_kernels.mul_1c = limbs_mul_1c_adx;
+			limb_kernels.addmul_1 = limbs_addmul_1_adx;
+			limb_kernels.submul_1 = limbs_submul_1_adx;
+			limb_kernels.name = "x86-64 bmi2/adx";
+		}
+#endif
+		return 1;
+	}
+	static int limb_kernels_selected = limbs_select_kernels();
+
+	// Name of the kernel set picked for this CPU
+	const char *bigint_kernels(void)
+	{
+		return limb_kernels.name;
+	}
+
+	static inline u64 limbs_add_n(u64 *rp, const u64 *ap, const u64 *bp, int n)
+	{
+		return limb_kernels.add_n(rp, ap, bp, n);
+	}
+
+	static inline u64 limbs_sub_n(u64 *rp, const u64 *ap, const u64 *bp, int n)
+	{
+		return limb_kernels.sub_n(rp, ap, bp, n);
+	}
+
+	static inline u64 limbs_mul_1c(u64 *rp, const u64 *ap, int n, u64 b, u64 carry)
+	{
+		return limb_kernels.mul_1c(rp, ap, n, b, carry);
+	}
+
+	static inline u64 limbs_mul_1(u64 *rp, const u64 *ap, int n, u64 b)
+	{
+		return limb_kernels.mul_1c(rp, ap, n, b, 0);
+	}
+
+	static inline u64 limbs_addmul_1(u64 *rp, const u64 *ap, int n, u64 b)
+	{
+		return limb_kernels.addmul_1(rp, ap, n, b);
+	}
+
+	static inline u64 limbs_submul_1(u64 *rp, const u64 *ap, int n, u64 b)
+	{
+		return limb_kernels.submul_1(rp, ap, n, b);
+	}
+
+	// rp[0..n) = ap + b, returns the carry out. In place it stops as soon as
+	// the carry dies out.
+	static u64 limbs_add_1(u64 *rp, const u64 *ap, int n, u64 b)
+	{
+		int i = 0;
+		for (; i < n && b; i++)
+		{
+			u64 sum = ap[i] + b;
+			b = sum < b;
+			rp[i] = sum;
+		}
+		if (rp != ap && i < n)
+			memcpy(rp + i, ap + i, (n - i) * sizeof(u64));
+		return b;
+	}
+
+	// rp[0..n) = ap - b, returns the borrow out
+	static u64 limbs_sub_1(u64 *rp, const u64 *ap, int n, u64 b)
+	{
+		int i = 0;
+		for (; i < n && b; i++)
+		{
+			u64 x = ap[i];
+			rp[i] = x - b;
+			b = x < b;
+		}
+		if (rp != ap && i < n)
+			memcpy(rp + i, ap + i, (n - i) * sizeof(u64));
+		return b;
+	}
+
+	// rp[0..an) = ap[0..an) + bp[0..bn) for an >= bn, returns the carry out
+	static u64 limbs_add(u64 *rp, const u64 *ap, int an, const u64 *bp, int bn)
+	{
+		u64 carry = limbs_add_n(rp, ap, bp, bn);
+		return limbs_add_1(rp + bn, ap + bn, an - bn, carry);
+	}
+
+	// rp[0..an) = ap[0..an) - bp[0..bn) for an >= bn, returns the borrow out
+	static u64 limbs_sub(u64 *rp, const u64 *ap, int an, const u64 *bp, int bn)
+	{
+		u64 borrow = limbs_sub_n(rp, ap, bp, bn);
+		return limbs_sub_1(rp + bn, ap + bn, an - bn, borrow);
+	}
+
+	// qp[0..n) = ap / d, returns the remainder
+	static u64 limbs_divrem_1(u64 *qp, const u64 *ap, int n, u64 d)
+	{
+		u64 rem = 0;
+		for (int i = n - 1; i >= 0; i--)
+		{
+			__uint128_t cur = ((__uint128_t)rem << 64) | ap[i];
+			qp[i] = (u64)(cur / d);
+			rem = (u64)(cur % d);
+		}
+		return rem;
+	}
+
+	// rp[0..n) = ap << s for 0 <= s < 64, returns the bits shifted out
+	static u64 limbs_lshift(u64 *rp, const u64 *ap, int n, int s)
+	{
+		if (s == 0)
+		{
+			memmove(rp, ap, n * sizeof(u64));
+			return 0;
+		}
+		u64 out = ap[n - 1] >> (64 - s);
+		for (int i = n - 1; i > 0; i--)
+			rp[i] = (ap[i] << s) | (ap[i - 1] >> (64 - s));
+		rp[0] = ap[0] << s;
+		return out;
+	}
+
+	// rp[0..n) = ap >> s for 0 <= s < 64, returns the bits shifted out (in
+	// the top of the limb)
+	static u64 limbs_rshift(u64 *rp, const u64 *ap, int n, int s)
+	{
+		if (s == 0)
+		{
+			memmove(rp, ap, n * sizeof(u64));
+			return 0;
+		}
+		u64 out = ap[0] << (64 - s);
+		for (int i = 0; i < n - 1; i++)
+			rp[i] = (ap[i] >> s) | (ap[i + 1] << (64 - s));
+		rp[n - 1] = ap[n - 1] >> s;
+		return out;
+	}
+
+	static int limbs_cmp(const u64 *ap, const u64 *bp, int n)
+	{
+		for (int i = n - 1; i >= 0; i--)
+			if (ap[i] != bp[i])
+				return ap[i] < bp[i] ? -1 : 1;
+		return 0;
+	}
+
+	static int limbs_is_zero(const u64 *ap, int n)
+	{
+		for (int i = 0; i < n; i++)
+			if (ap[i])
+				return 0;
+		return 1;
+	}
+
+	// ---------- Initialization ----------
+	void bigint_init(BigInt *num, long long value)
+	{
+		memset(num->small, 0, sizeof(num->small));
+		num->limbs = num->small;
+		num->size = 0;
+		num->capacity = BIGINT_INLINE_LIMBS;
+		num->sign = 0;
+
+		num->limbs[0] = (u64)((value < 0) ? -value : value);
+		num->size = (value != 0) ? 1 : 0;
+		num->sign = (value < 0) ? -1 : 1;
+	}
+
+	// ---------- Basic Utilities ----------
+	int bigint_compare(const BigInt *a, const BigInt *b)
+	{
+		if (a->sign != b->sign)
+			return (a->sign < b->sign) ? -1 : 1;
+		if (a->size != b->size)
+			return (a->size < b->size) ? -1 : 1;
+
+		for (int i = a->size - 1; i >= 0; --i)
+		{
+			if (a->limbs[i] != b->limbs[i])
+				return (a->limbs[i] < b->limbs[i]) ? -1 : 1;
+		}
+		return 0;
+	}
+
+	// ---------- Arithmetic ----------
+	void bigint_add(const BigInt *a, const BigInt *b, BigInt *result);
+	void bigint_subtract(const BigInt *a, const BigInt *b, BigInt *result);
+
+	void bigint_add_u64(const BigInt *a, u64 b, BigInt *result)
+	{
+		int n = a->size;
+		bigint_reserve(result, n + 1);
+		u64 carry = limbs_add_1(result->limbs, a->limbs, n, b);
+		if (carry)
+			result->limbs[n++] = carry;
+		result->size = n;
+		result->sign = a->sign;
+	}
+
+	void bigint_multiply_u64(const BigInt *a, u64 b, BigInt *result)
+	{
+		if (b == 0 || a->size == 0)
+		{
+			bigint_reserve(result, 1);
+			result->limbs[0] = 0;
+			result->size = 1;
+			result->sign = 0;
+			return;
+		}
+
+		bigint_reserve(result, a->size + 1);
+		u64 carry = limbs_mul_1(result->limbs, a->limbs, a->size, b);
+		if (carry)
+		{
+			result->limbs[a->size] = carry;
+			result->size = a->size + 1;
+		}
+		else
+		{
+			result->size = a->size;
+		}
+		result->sign = a->sign;
+	}
+
+	static int compare_abs(const BigInt *a, const BigInt *b)
+	{
+		if (a->size != b->size)
+			return (a->size < b->size) ? -1 : 1;
+		return limbs_cmp(a->limbs, b->limbs, a->size);
+	}
+
+	// result = |a| - |b|, signed
+	void bigint_subtract(const BigInt *a, const BigInt *b, BigInt *result)
+	{
+		int sign = 1;
+		if (compare_abs(a, b) < 0)
+		{
+			const BigInt *t = a;
+			a = b;
+			b = t;
+			sign = -1;
+		}
+
+		int a_size = a->size;
+		bigint_reserve(result, a_size);
+		limbs_sub(result->limbs, a->limbs, a_size, b->limbs, b->size);
+		result->size = a_size;
+		while (result->size > 1 && result->limbs[result->size - 1] == 0)
+			result->size--;
+		result->sign = (result->size == 1 && result->limbs[0] == 0) ? 1 : sign;
+	}
+
+	void bigint_add(const BigInt *a, const BigInt *b, BigInt *result)
+	{
+		if (a->size == 0)
+		{
+			bigint_copy(result, b);
+			return;
+		}
+		if (b->size == 0)
+		{
+			bigint_copy(result, a);
+			return;
+		}
+
+		// Mixed signs reduce to a magnitude subtraction
+		if (a->sign >= 0 && b->sign < 0)
+		{
+			bigint_subtract(a, b, result);
+			return;
+		}
+		if (a->sign < 0 && b->sign >= 0)
+		{
+			bigint_subtract(b, a, result);
+			return;
+		}
+		int sign = (a->sign < 0 && b->sign < 0) ? -1 : 1;
+
+		if (a->size < b->size)
+		{
+			const BigInt *t = a;
+			a = b;
+			b = t;
+		}
+		int n = a->size;
+		bigint_reserve(result, n + 1);
+		u64 carry = limbs_add(result->limbs, a->limbs, n, b->limbs, b->size);
+		if (carry)
+			result->limbs[n++] = carry;
+		result->size = n;
+		result->sign = sign;
+	}
+
+	// ---------- Tuning ----------
+	// The crossovers between the multiplication, squaring and division tiers
+	// move a lot between hosts, so those cutoffs are read from `tuning` at
+	// run time instead of being fixed. Their defaults come from a generated
+	// bigint_tuned.h when the build finds one (running this program with
+	// --tune writes it) and from the built-in values otherwise. The same file
+	// can be loaded at startup instead, through BIGINT_TUNING=<path> or
+	// bigint_load_tuning.
+#if defined(__has_include)
+#if __has_include("bigint_tuned.h")
+#include "bigint_tuned.h"
+#endif
+#endif
+#ifndef TUNED_KARATSUBA_THRESHOLD
+#define TUNED_KARATSUBA_THRESHOLD 32
+#endif
+#ifndef TUNED_TOOM3_THRESHOLD
+#define TUNED_TOOM3_THRESHOLD 160
+#endif
+#ifndef TUNED_NTT_THRESHOLD
+#define TUNED_NTT_THRESHOLD 2048
+#endif
+#ifndef TUNED_SQR_BASECASE_THRESHOLD
+#define TUNED_SQR_BASECASE_THRESHOLD 20
+#endif
+#ifndef TUNED_SQR_KARATSUBA_THRESHOLD
+#define TUNED_SQR_KARATSUBA_THRESHOLD 48
+#endif
+#ifndef TUNED_SQR_TOOM3_THRESHOLD
+#define TUNED_SQR_TOOM3_THRESHOLD 240
+#endif
+#ifndef TUNED_SQR_NTT_THRESHOLD
+#define TUNED_SQR_NTT_THRESHOLD 2048
+#endif
+#ifndef TUNED_DIV_NEWTON_THRESHOLD
+#define TUNED_DIV_NEWTON_THRESHOLD 1000
+#endif
+
+	enum
+	{
+		TUNE_KARATSUBA,
+		TUNE_TOOM3,
+		TUNE_NTT,
+		TUNE_SQR_BASECASE,
+		TUNE_SQR_KARATSUBA,
+		TUNE_SQR_TOOM3,
+		TUNE_SQR_NTT,
+		TUNE_DIV_NEWTON,
+		TUNE_COUNT
+	};
+
+	static int tuning[TUNE_COUNT] = {TUNED_KARATSUBA_THRESHOLD, TUNED_TOOM3_THRESHOLD, TUNED_NTT_THRESHOLD,
+									 TUNED_SQR_BASECASE_THRESHOLD, TUNED_SQR_KARATSUBA_THRESHOLD,
+									 TUNED_SQR_TOOM3_THRESHOLD, TUNED_SQR_NTT_THRESHOLD, TUNED_DIV_NEWTON_THRESHOLD};
+	static const char *const tuning_names[TUNE_COUNT] = {
+		"KARATSUBA_THRESHOLD", "TOOM3_THRESHOLD", "NTT_THRESHOLD", "SQR_BASECASE_THRESHOLD",
+		"SQR_KARATSUBA_THRESHOLD", "SQR_TOOM3_THRESHOLD", "SQR_NTT_THRESHOLD", "DIV_NEWTON_THRESHOLD"};
+	// Smallest sizes the tiers accept (Toom-3 needs a non-empty top piece)
+	static const int tuning_min[TUNE_COUNT] = {4, 8, 8, 1, 4, 8, 8, 4};
+
+	// Raises any cutoff that sits below the tier it takes over from. The
+	// scratch sizing and the dispatch both walk the tiers bottom-up, so an
+	// NTT cutoff under the Toom-3 one would send sizes to Toom-3 that were
+	// sized for the NTT (which needs no scratch).
+	static void tuning_order(void)
+	{
+		for (int i = 1; i < TUNE_COUNT; i++)
+			if (i != TUNE_SQR_BASECASE && i != TUNE_DIV_NEWTON && tuning[i] < tuning[i - 1])
+				tuning[i] = tuning[i - 1];
+	}
+
+	// Reads cutoffs from a file in the generated header's format, lines of
+	// "#define TUNED_<NAME> <limbs>". Returns how many were set, or -1 when
+	// the file cannot be opened. Cutoffs out of order are raised to the
+	// tier below them.
+	int bigint_load_tuning(const char *path)
+	{
+		FILE *f = fopen(path, "r");
+		if (!f)
+			return -1;
+		char line[256], name[128];
+		int value, count = 0;
+		while (fgets(line, sizeof(line), f))
+		{
+			if (sscanf(line, " #define TUNED_%127s %d", name, &value) != 2)
+				continue;
+			for (int i = 0; i < TUNE_COUNT; i++)
+				if (!strcmp(name, tuning_names[i]))
+				{
+					tuning[i] = value > tuning_min[i] ? value : tuning_min[i];
+					count++;
+				}
+		}
+		fclose(f);
+		tuning_order();
+		return count;
+	}
+
+	static int tuning_from_env(void)
+	{
+		const char *path = getenv("BIGINT_TUNING");
+		if (path && bigint_load_tuning(path) < 0)
+			fprintf(stderr, "Warning: cannot read BIGINT_TUNING file %s\n", path);
+		tuning_order();
+		return 1;
+	}
+	static int tuning_loaded = tuning_from_env();
+
+	// ---------- Threads ----------
+	// Huge products fan out over a pool of worker threads. A job is a set of
+	// numbered tasks; the submitting thread runs tasks of its own job as well
+	// and only ever waits for tasks another thread has already started, so
+	// jobs may nest (a Toom-3 sub-product fanning out again) without
+	// deadlock. Toom-3 from MUL_THREAD_THRESHOLD limbs runs its five
+	// sub-products as tasks, and transforms from NTT_THREAD_THRESHOLD points
+	// split their butterflies; everything smaller stays on the calling thread.
+	// Each worker draws its temporaries from its own scratch arena.
+#define MUL_THREAD_THRESHOLD 512
+#define NTT_THREAD_THRESHOLD 8192
+
+	typedef struct
+	{
+		void (*fn)(void *, int);
+		void *ctx;
+		int count;
+		std::atomic<int> next; // next task to claim
+		int done;			   // guarded by the pool lock
+	} ParallelJob;
+
+	typedef struct
+	{
+		std::mutex lock;
+		std::condition_variable wake;	  // a job was posted, or stop
+		std::condition_variable finished; // a task completed
+		std::vector<ParallelJob *> jobs;  // jobs with tasks left to claim
+		std::vector<std::thread> workers;
+		bool stop;
+	} ThreadPool;
+
+	static std::mutex pool_config_lock;
+	static ThreadPool *pool;
+	static int pool_threads; // 0 until configured: one per hardware thread
+
+	static void pool_worker(ThreadPool *tp)
+	{
+		std::unique_lock<std::mutex> guard(tp->lock);
+		for (;;)
+		{
+			tp->wake.wait(guard, [tp] { return tp->stop || !tp->jobs.empty(); });
+			if (tp->stop)
+				return;
+			ParallelJob *job = tp->jobs.back();
+			int i = job->next.fetch_add(1);
+			if (i >= job->count - 1)
+				tp->jobs.pop_back();
+			if (i >= job->count)
+				continue;
+			guard.unlock();
+			job->fn(job->ctx, i);
+			guard.lock();
+			if (++job->done == job->count)
+				tp->finished.notify_all();
+		}
+	}
+
+	static void pool_shutdown(void)
+	{
+		if (!pool)
+			return;
+		{
+			std::lock_guard<std::mutex> guard(pool->lock);
+			pool->stop = true;
+		}
+		pool->wake.notify_all();
+		for (std::thread &t : pool->workers)
+			t.join();
+		delete pool;
+		pool = NULL;
+	}
+
+	struct PoolReaper
+	{
+		~PoolReaper() { pool_shutdown(); }
+	};
+	static PoolReaper pool_reaper;
+
+	// Threads a product may use (the caller's included)
+	int bigint_get_threads(void)
+	{
+		std::lock_guard<std::mutex> guard(pool_config_lock);
+		if (pool_threads == 0)
+		{
+			unsigned hw = std::thread::hardware_concurrency();
+			pool_threads = hw ? (int)hw : 1;
+		}
+		return pool_threads;
+	}
+
+	// Sets the thread count; n <= 0 means one per hardware thread, 1 keeps
+	// everything on the calling thread. Not to be called while another
+	// thread is inside a multiplication.
+	void bigint_set_threads(int n)
+	{
+		if (n <= 0)
+		{
+			unsigned hw = std::thread::hardware_concurrency();
+			n = hw ? (int)hw : 1;
+		}
+		std::lock_guard<std::mutex> guard(pool_config_lock);
+		pool_shutdown();
+		pool_threads = n;
+	}
+
+	static ThreadPool *thread_pool(void)
+	{
+		int n = bigint_get_threads();
+		std::lock_guard<std::mutex> guard(pool_config_lock);
+		if (!pool && n > 1)
+		{
+			pool = new ThreadPool();
+			pool->stop = false;
+			for (int i = 1; i < n; i++)
+				pool->workers.emplace_back(pool_worker, pool);
+		}
+		return pool;
+	}
+
+	// Runs fn(ctx, 0..count-1) across the pool and returns when all are done
+	static void parallel_run(int count, void (*fn)(void *, int), void *ctx)
+	{
+		ThreadPool *tp = count > 1 ? thread_pool() : NULL;
+		if (!tp)
+		{
+			for (int i = 0; i < count; i++)
+				fn(ctx, i);
+			return;
+		}
+
+		ParallelJob job;
+		job.fn = fn;
+		job.ctx = ctx;
+		job.count = count;
+		job.next = 0;
+		job.done = 0;
+		{
+			std::lock_guard<std::mutex> guard(tp->lock);
+			tp->jobs.push_back(&job);
+		}
+		tp->wake.notify_all();
+
+		for (int i; (i = job.next.fetch_add(1)) < count;)
+		{
+			fn(ctx, i);
+			std::lock_guard<std::mutex> guard(tp->lock);
+			job.done++;
+		}
+
+		std::unique_lock<std::mutex> guard(tp->lock);
+		std::vector<ParallelJob *>::iterator it = std::find(tp->jobs.begin(), tp->jobs.end(), &job);
+		if (it != tp->jobs.end())
+			tp->jobs.erase(it);
+		tp->finished.wait(guard, [&job] { return job.done == job.count; });
+	}
+
+	template <class F>
+	static void parallel_for(int count, const F &f)
+	{
+		parallel_run(count, [](void *ctx, int i) { (*(const F *)ctx)(i); }, (void *)&f);
+	}
+
+	// Number of tasks worth splitting a job of this size into
+	static int parallel_tasks(size_t size, size_t threshold)
+	{
+		return size >= threshold ? bigint_get_threads() : 1;
+	}
+
+	// ---------- Multiplication ----------
+	// Below KARATSUBA_THRESHOLD limbs the 128-bit schoolbook loop wins, below
+	// TOOM3_THRESHOLD Karatsuba does and below NTT_THRESHOLD Toom-3 does. The
+	// recursive tiers work on raw limb arrays and carve their temporaries out
+	// of one scratch buffer allocated up front; the NTT allocates its own.
+#define KARATSUBA_THRESHOLD tuning[TUNE_KARATSUBA]
+#define TOOM3_THRESHOLD tuning[TUNE_TOOM3]
+#define NTT_THRESHOLD tuning[TUNE_NTT]
+
+	// rp[0..an+bn) = ap * bp, rp must not overlap the inputs
+	static void mul_basecase(u64 *rp, const u64 *ap, int an, const u64 *bp, int bn)
+	{
+		rp[bn] = limbs_mul_1(rp, bp, bn, ap[0]);
+		for (int i = 1; i < an; i++)
+			rp[i + bn] = limbs_addmul_1(rp + i, bp, bn, ap[i]);
+	}
+
+	// rp[off..rn) += xp[0..xn) with carry propagation inside rn limbs. Limbs of
+	// xp that fall past rn must be zero (the caller knows the true size).
+	static void limbs_add_at(u64 *rp, int rn, int off, const u64 *xp, int xn)
+	{
+		if (xn > rn - off)
+			xn = rn - off;
+		u64 carry = limbs_add_n(rp + off, rp + off, xp, xn);
+		limbs_add_1(rp + off + xn, rp + off + xn, rn - off - xn, carry);
+	}
+
+	// rp[0..n) = |xp - yp|, returns 1 when xp < yp. xp has n limbs, yp has
+	// yn <= n limbs (zero-extended). rp may be xp.
+	static int limbs_abs_diff(u64 *rp, const u64 *xp, int n, const u64 *yp, int yn)
+	{
+		int i = n - 1;
+		while (i >= yn && xp[i] == 0)
+			i--;
+		if (i < yn)
+		{
+			while (i >= 0 && xp[i] == yp[i])
+				i--;
+		}
+		int neg = (i >= 0 && i < yn && xp[i] < yp[i]);
+		if (!neg)
+		{
+			limbs_sub(rp, xp, n, yp, yn);
+			return 0;
+		}
+		// xp < yp, so the limbs of xp past yn are zero
+		limbs_sub_n(rp, yp, xp, yn);
+		memset(rp + yn, 0, (n - yn) * sizeof(u64));
+		return 1;
+	}
+
+	static int mul_n_itch(int n)
+	{
+		if (n < KARATSUBA_THRESHOLD || n >= NTT_THRESHOLD)
+			return 0;
+		if (n < TOOM3_THRESHOLD)
+		{
+			int l = n - n / 2;
+			int sub = mul_n_itch(l);
+			int sub_h = mul_n_itch(n / 2);
+			return 4 * l + 1 + (sub > sub_h ? sub : sub_h);
+		}
+		int k = (n + 2) / 3, w = 2 * k + 2;
+		int sub = mul_n_itch(k + 1);
+		int sub_k = mul_n_itch(k), sub_s = mul_n_itch(n - 2 * k);
+		if (sub_k > sub)
+			sub = sub_k;
+		if (sub_s > sub)
+			sub = sub_s;
+		return 2 * (k + 1) + 3 * w + sub;
+	}
+
+	static void mul_n(u64 *rp, const u64 *ap, const u64 *bp, int n, u64 *scratch);
+	static void sqr_n(u64 *rp, const u64 *ap, int n, u64 *scratch);
+
+	// Karatsuba: a = a0 + a1*B^l, b = b0 + b1*B^l and
+	// a*b = z0 + (z0 + z2 -+ |a0-a1|*|b0-b1|)*B^l + z2*B^2l
+	static void mul_karatsuba(u64 *rp, const u64 *ap, const u64 *bp, int n, u64 *scratch)
+	{
+		int h = n / 2, l = n - h;
+		u64 *zm = scratch, *da = scratch + 2 * l, *db = da + l, *next = scratch + 4 * l + 1;
+
+		int neg = limbs_abs_diff(da, ap, l, ap + l, h);
+		neg ^= limbs_abs_diff(db, bp, l, bp + l, h);
+		mul_n(zm, da, db, l, next);
+		mul_n(rp, ap, bp, l, next);
+		mul_n(rp + 2 * l, ap + l, bp + l, h, next);
+
+		// t = z0 + z2 -+ zm, spanning 2l+1 limbs (reuses da/db)
+		u64 *t = da;
+		memcpy(t, rp, 2 * l * sizeof(u64));
+		t[2 * l] = 0;
+		limbs_add_at(t, 2 * l + 1, 0, rp + 2 * l, 2 * h);
+		if (neg)
+			t[2 * l] += limbs_add_n(t, t, zm, 2 * l);
+		else
+			t[2 * l] -= limbs_sub_n(t, t, zm, 2 * l);
+		limbs_add_at(rp, 2 * n, l, t, 2 * l + 1);
+	}
+
+	// ---- Toom-3 helpers (values are kept mod B^w in two's complement) ----
+	static void wrap_add(u64 *rp, int w, const u64 *xp, int xn)
+	{
+		u64 carry = limbs_add_n(rp, rp, xp, xn);
+		limbs_add_1(rp + xn, rp + xn, w - xn, carry);
+	}
+
+	static void wrap_sub(u64 *rp, int w, const u64 *xp, int xn)
+	{
+		u64 borrow = limbs_sub_n(rp, rp, xp, xn);
+		limbs_sub_1(rp + xn, rp + xn, w - xn, borrow);
+	}
+
+	static void wrap_negate(u64 *rp, int w)
+	{
+		u64 carry = 1;
+		for (int i = 0; i < w; i++)
+		{
+			rp[i] = ~rp[i] + carry;
+			carry = carry && rp[i] == 0;
+		}
+	}
+
+	// Arithmetic shift right by one bit; the value must be even.
+	static void wrap_half(u64 *rp, int w)
+	{
+		for (int i = 0; i < w - 1; i++)
+			rp[i] = (rp[i] >> 1) | (rp[i + 1] << 63);
+		rp[w - 1] = (u64)((long long)rp[w - 1] >> 1);
+	}
+
+	// Exact division by 3 (Hensel style); the value must be a multiple of 3.
+	static void wrap_divexact_3(u64 *rp, int w)
+	{
+		const u64 inv3 = 0xAAAAAAAAAAAAAAABULL; // 3 * inv3 == 1 mod 2^64
+		u64 carry = 0;
+		for (int i = 0; i < w; i++)
+		{
+			u64 x = rp[i];
+			u64 l = x - carry;
+			carry = (x < carry);
+			u64 q = l * inv3;
+			rp[i] = q;
+			carry += (u64)(((__uint128_t)q * 3) >> 64);
+		}
+	}
+
+	// Evaluates a0 + t*a1 + t^2*a2 for t = 1, -1, 2 into k+1 limbs. Returns the
+	// sign of the result for t = -1 (1 when negative).
+	static int toom3_eval(u64 *ep, const u64 *ap, int k, int s, int t)
+	{
+		const u64 *a0 = ap, *a1 = ap + k, *a2 = ap + 2 * k;
+		int neg = 0;
+		if (t == 1)
+		{
+			memcpy(ep, a0, k * sizeof(u64));
+			ep[k] = 0;
+			wrap_add(ep, k + 1, a2, s);
+			wrap_add(ep, k + 1, a1, k);
+		}
+		else if (t == -1)
+		{
+			// |a0 + a2 - a1|
+			memcpy(ep, a0, k * sizeof(u64));
+			ep[k] = 0;
+			wrap_add(ep, k + 1, a2, s);
+			u64 *hi = ep + k;
+			if (*hi == 0)
+				neg = limbs_abs_diff(ep, ep, k, a1, k);
+			else
+				*hi -= limbs_sub_n(ep, ep, a1, k);
+		}
+		else
+		{
+			// (a2*2 + a1)*2 + a0
+			memset(ep, 0, (k + 1) * sizeof(u64));
+			ep[s] = limbs_lshift(ep, a2, s, 1);
+			wrap_add(ep, k + 1, a1, k);
+			limbs_lshift(ep, ep, k + 1, 1);
+			wrap_add(ep, k + 1, a0, k);
+		}
+		return neg;
+	}
+
+	// Recovers the product in rp[0..2n) from v0 = rp[0..2k), vinf =
+	// rp[4k..4k+2s) and the w-limb values at 1, -1 and 2, with the same
+	// sequence GMP uses (two exact halvings and one exact division by 3).
+	static void toom3_interpolate(u64 *rp, int n, int k, int s, u64 *v1, u64 *vm1, u64 *v2)
+	{
+		int w = 2 * k + 2;
+		const u64 *v0 = rp, *vinf = rp + 4 * k;
+
+		wrap_sub(v2, w, vm1, w); // r3 = (v2 - vm1) / 3
+		wrap_divexact_3(v2, w);
+		wrap_sub(v1, w, vm1, w); // r1 = (v1 - vm1) / 2
+		wrap_half(v1, w);
+		wrap_sub(vm1, w, v0, 2 * k); // r2 = vm1 - v0
+		wrap_sub(v2, w, vm1, w);     // r3 = (r3 - r2) / 2
+		wrap_half(v2, w);
+		wrap_add(vm1, w, v1, w); // r2 = r2 + r1 - vinf
+		wrap_sub(vm1, w, vinf, 2 * s);
+		wrap_sub(v2, w, v1, w); // r3 = r3 - r1 - 2*vinf
+		wrap_sub(v2, w, vinf, 2 * s);
+		wrap_sub(v2, w, vinf, 2 * s);
+		wrap_sub(v1, w, v2, w); // r1 = r1 - r3
+
+		memset(rp + 2 * k, 0, 2 * k * sizeof(u64));
+		limbs_add_at(rp, 2 * n, k, v1, w);
+		limbs_add_at(rp, 2 * n, 2 * k, vm1, w);
+		limbs_add_at(rp, 2 * n, 3 * k, v2, w);
+	}
+
+	// Toom-3 of a*b (bp == NULL: a^2) with the five sub-products running as
+	// concurrent tasks. Every point gets its own evaluation buffers and each
+	// task its own itch limbs of scratch, all taken from the caller's arena.
+	static void toom3_parallel(u64 *rp, const u64 *ap, const u64 *bp, int n, int itch)
+	{
+		int k = (n + 2) / 3, s = n - 2 * k, w = 2 * k + 2;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *ev = scratch_alloc(6 * (size_t)(k + 1));
+		u64 *v1 = scratch_alloc(3 * (size_t)w), *vm1 = v1 + w, *v2 = vm1 + w;
+		u64 *next = scratch_alloc(5 * (size_t)itch + 1);
+
+		const int points[3] = {1, -1, 2};
+		int neg = 0;
+		for (int t = 0; t < 3; t++)
+		{
+			u64 *ea = ev + 2 * t * (k + 1);
+			int sign = toom3_eval(ea, ap, k, s, points[t]);
+			if (bp)
+				sign ^= toom3_eval(ea + k + 1, bp, k, s, points[t]);
+			if (t == 1)
+				neg = sign;
+		}
+
+		parallel_for(5, [=](int t) {
+			u64 *out = v1 + t * w, *sc = next + (size_t)t * itch;
+			const u64 *x = ev + 2 * t * (k + 1), *y = x + k + 1;
+			int m = k + 1;
+			if (t == 3) // v0
+				out = rp, x = ap, y = bp, m = k;
+			else if (t == 4) // vinf
+				out = rp + 4 * k, x = ap + 2 * k, y = bp ? bp + 2 * k : NULL, m = s;
+			if (bp)
+				mul_n(out, x, y, m, sc);
+			else
+				sqr_n(out, x, m, sc);
+		});
+
+		if (bp && neg)
+			wrap_negate(vm1, w);
+		toom3_interpolate(rp, n, k, s, v1, vm1, v2);
+		scratch_release(mark);
+	}
+
+	// Toom-3 with evaluation points 0, 1, -1, 2, inf
+	static void mul_toom3(u64 *rp, const u64 *ap, const u64 *bp, int n, u64 *scratch)
+	{
+		int k = (n + 2) / 3, s = n - 2 * k, w = 2 * k + 2;
+		if (n >= MUL_THREAD_THRESHOLD && bigint_get_threads() > 1)
+		{
+			// what mul_n_itch(n) reserves for one sub-product
+			toom3_parallel(rp, ap, bp, n, mul_n_itch(n) - 2 * (k + 1) - 3 * w);
+			return;
+		}
+		u64 *ea = scratch, *eb = ea + k + 1;
+		u64 *v1 = eb + k + 1, *vm1 = v1 + w, *v2 = vm1 + w, *next = v2 + w;
+
+		toom3_eval(ea, ap, k, s, 1);
+		toom3_eval(eb, bp, k, s, 1);
+		mul_n(v1, ea, eb, k + 1, next);
+
+		int neg = toom3_eval(ea, ap, k, s, -1);
+		neg ^= toom3_eval(eb, bp, k, s, -1);
+		mul_n(vm1, ea, eb, k + 1, next);
+		if (neg)
+			wrap_negate(vm1, w);
+
+		toom3_eval(ea, ap, k, s, 2);
+		toom3_eval(eb, bp, k, s, 2);
+		mul_n(v2, ea, eb, k + 1, next);
+
+		mul_n(rp, ap, bp, k, next);                         // v0
+		mul_n(rp + 4 * k, ap + 2 * k, bp + 2 * k, s, next); // vinf
+		toom3_interpolate(rp, n, k, s, v1, vm1, v2);
+	}
+
+	// ---------- NTT Multiplication ----------
+	// The product is a cyclic convolution of the limb vectors, computed modulo
+	// three primes p = k*2^e + 1 below 2^62 and recombined with Garner's CRT.
+	// One convolution term is below N*2^128, far inside p1*p2*p3 ~ 2^184, so
+	// whole 64-bit limbs go into the transform without splitting.
+	typedef struct
+	{
+		u64 p;	   // modulus
+		u64 pn;	   // -p^-1 mod 2^64
+		u64 r1;	   // 2^64 mod p
+		u64 r2;	   // 2^128 mod p
+		u64 root;  // primitive root
+		int order; // largest e with 2^e | p - 1
+	} NttPrime;
+
+	static int ntt_init_primes(NttPrime *primes)
+	{
+		const u64 ps[3] = {29ULL * (1ULL << 57) + 1, 69ULL * (1ULL << 55) + 1, 27ULL * (1ULL << 56) + 1};
+		const u64 roots[3] = {3, 5, 5};
+		const int orders[3] = {57, 55, 56};
+		for (int i = 0; i < 3; i++)
+		{
+			u64 p = ps[i], inv = p;
+			for (int k = 0; k < 5; k++)
+				inv *= 2 - p * inv;
+			primes[i].p = p;
+			primes[i].pn = 0 - inv;
+			primes[i].r1 = (u64)(((__uint128_t)1 << 64) % p);
+			primes[i].r2 = (u64)((__uint128_t)primes[i].r1 * primes[i].r1 % p);
+			primes[i].root = roots[i];
+			primes[i].order = orders[i];
+		}
+		return 1;
+	}
+
+	static const NttPrime *ntt_primes(void)
+	{
+		static NttPrime primes[3];
+		static int ready = ntt_init_primes(primes); // once, even across threads
+		(void)ready;
+		return primes;
+	}
+
+	// a*b/2^64 mod p, valid for a < 2^64 and b < p
+	static inline u64 mont_mul(u64 a, u64 b, u64 p, u64 pn)
+	{
+		__uint128_t t = (__uint128_t)a * b;
+		u64 m = (u64)t * pn;
+		u64 u = (u64)((t + (__uint128_t)m * p) >> 64);
+		return u >= p ? u - p : u;
+	}
+
+	static u64 ntt_pow(u64 b, u64 e, u64 p)
+	{
+		u64 r = 1;
+		for (; e; e >>= 1, b = (u64)((__uint128_t)b * b % p))
+			if (e & 1)
+				r = (u64)((__uint128_t)r * b % p);
+		return r;
+	}
+
+	// rt[len + j] = w_{2len}^j in Montgomery form for every power of two len
+	// < n. Rows are cut into tasks chunks, each started from its own power.
+	static void ntt_roots(u64 *rt, size_t n, const NttPrime *pr, int tasks)
+	{
+		for (size_t len = 1; len < n; len <<= 1)
+		{
+			u64 w0 = ntt_pow(pr->root, (pr->p - 1) / (2 * len), pr->p);
+			u64 w = mont_mul(w0, pr->r2, pr->p, pr->pn);
+			int chunks = len >= NTT_THREAD_THRESHOLD / 2 ? tasks : 1;
+			parallel_for(chunks, [=](int t) {
+				size_t j0 = len * t / chunks, j1 = len * (t + 1) / chunks;
+				u64 x = mont_mul(ntt_pow(w0, j0, pr->p), pr->r2, pr->p, pr->pn);
+				for (size_t j = j0; j < j1; j++)
+				{
+					rt[len + j] = x;
+					x = mont_mul(x, w, pr->p, pr->pn);
+				}
+			});
+		}
+	}
+
+	// One decimation-in-frequency stage, restricted to butterflies j0 <= j < j1
+	static inline void ntt_forward_stage(u64 *a, size_t n, size_t len, size_t j0, size_t j1, const u64 *rt, u64 p, u64 pn)
+	{
+		for (size_t i = 0; i < n; i += 2 * len)
+			for (size_t j = j0; j < j1; j++)
+			{
+				u64 u = a[i + j], v = a[i + j + len];
+				u64 s = u + v;
+				a[i + j] = s >= p ? s - p : s;
+				a[i + j + len] = mont_mul(u >= v ? u - v : u + p - v, rt[len + j], p, pn);
+			}
+	}
+
+	// One decimation-in-time stage with inverse twiddles; w^-j is taken as
+	// -w^(len-j) from the same table, so j = 0 has its own untwisted form.
+	static inline void ntt_inverse_stage(u64 *a, size_t n, size_t len, size_t j0, size_t j1, const u64 *rt, u64 p, u64 pn)
+	{
+		for (size_t i = 0; i < n; i += 2 * len)
+		{
+			size_t j = j0;
+			if (j == 0 && j1 > 0)
+			{
+				u64 u = a[i], v = a[i + len];
+				u64 s = u + v;
+				a[i] = s >= p ? s - p : s;
+				a[i + len] = u >= v ? u - v : u + p - v;
+				j = 1;
+			}
+			for (; j < j1; j++)
+			{
+				u64 u = a[i + j];
+				u64 v = mont_mul(a[i + j + len], rt[2 * len - j], p, pn);
+				u64 s = u + v;
+				a[i + j + len] = s >= p ? s - p : s;
+				a[i + j] = u >= v ? u - v : u + p - v;
+			}
+		}
+	}
+
+	// Decimation in frequency: natural order in, bit-reversed order out
+	static void ntt_forward(u64 *a, size_t n, const u64 *rt, u64 p, u64 pn)
+	{
+		for (size_t len = n >> 1; len >= 1; len >>= 1)
+			ntt_forward_stage(a, n, len, 0, len, rt, p, pn);
+	}
+
+	// Decimation in time, unscaled: bit-reversed order in, natural order out
+	static void ntt_inverse(u64 *a, size_t n, const u64 *rt, u64 p, u64 pn)
+	{
+		for (size_t len = 1; len < n; len <<= 1)
+			ntt_inverse_stage(a, n, len, 0, len, rt, p, pn);
+	}
+
+	// Transforms split over tasks: the stages whose butterflies span more
+	// than one of `blocks` equal blocks divide their j range between the
+	// tasks, and the remaining stages run as independent transforms of one
+	// block each (the twiddle table is indexed by len, so they share it).
+	static size_t ntt_blocks(size_t n, int tasks)
+	{
+		size_t blocks = 1;
+		while ((int)blocks < tasks && blocks < n / NTT_THREAD_THRESHOLD * 8)
+			blocks <<= 1;
+		return blocks;
+	}
+
+	static void ntt_forward_tasks(u64 *a, size_t n, const u64 *rt, u64 p, u64 pn, int tasks)
+	{
+		size_t blocks = ntt_blocks(n, tasks), sub = n / blocks;
+		if (blocks == 1)
+		{
+			ntt_forward(a, n, rt, p, pn);
+			return;
+		}
+		for (size_t len = n >> 1; len >= sub; len >>= 1)
+			parallel_for(tasks, [=](int t) {
+				ntt_forward_stage(a, n, len, len * t / tasks, len * (t + 1) / tasks, rt, p, pn);
+			});
+		parallel_for((int)blocks, [=](int b) { ntt_forward(a + b * sub, sub, rt, p, pn); });
+	}
+
+	static void ntt_inverse_tasks(u64 *a, size_t n, const u64 *rt, u64 p, u64 pn, int tasks)
+	{
+		size_t blocks = ntt_blocks(n, tasks), sub = n / blocks;
+		if (blocks == 1)
+		{
+			ntt_inverse(a, n, rt, p, pn);
+			return;
+		}
+		parallel_for((int)blocks, [=](int b) { ntt_inverse(a + b * sub, sub, rt, p, pn); });
+		for (size_t len = sub; len < n; len <<= 1)
+			parallel_for(tasks, [=](int t) {
+				ntt_inverse_stage(a, n, len, len * t / tasks, len * (t + 1) / tasks, rt, p, pn);
+			});
+	}
+
+	// rp[0..an+bn) = ap * bp through three modular transforms. A square
+	// (ap == bp) needs only one forward transform per prime. From
+	// NTT_THREAD_THRESHOLD points every pass is split over the thread pool.
+	static void mul_ntt(u64 *rp, const u64 *ap, int an, const u64 *bp, int bn)
+	{
+		int square = (ap == bp && an == bn);
+		const NttPrime *primes = ntt_primes();
+		size_t rn = (size_t)an + bn, n = 1;
+		int log_n = 0;
+		while (n < rn)
+			n <<= 1, log_n++;
+		if (log_n > primes[1].order)
+		{
+			fprintf(stderr, "Error: operands too large for mul_ntt\n");
+			exit(EXIT_FAILURE);
+		}
+		int tasks = parallel_tasks(n, NTT_THREAD_THRESHOLD);
+
+		BigIntArenaMark mark = scratch_mark();
+		u64 *buf = scratch_alloc(5 * n);
+		u64 *res[3] = {buf, buf + n, buf + 2 * n};
+		u64 *fb = buf + 3 * n, *rt = buf + 4 * n;
+
+		for (int k = 0; k < 3; k++)
+		{
+			const NttPrime *pr = &primes[k];
+			u64 p = pr->p, pn = pr->pn, *fa = res[k];
+			// fa = a*R and fb = b*R/n, so that the Montgomery pointwise product
+			// followed by the unscaled inverse lands exactly on the convolution
+			u64 inv_n = ntt_pow(n % p, p - 2, p);
+			u64 scale = (u64)((__uint128_t)inv_n * pr->r1 % p);
+			parallel_for(tasks, [=](int t) {
+				size_t lo = n * t / tasks, hi = n * (t + 1) / tasks;
+				for (size_t i = lo; i < hi; i++)
+				{
+					fa[i] = i < (size_t)an ? mont_mul(ap[i], pr->r2, p, pn) : 0;
+					if (!square)
+						fb[i] = i < (size_t)bn ? mont_mul(bp[i], scale, p, pn) : 0;
+				}
+			});
+
+			ntt_roots(rt, n, pr, tasks);
+			ntt_forward_tasks(fa, n, rt, p, pn, tasks);
+			if (!square)
+				ntt_forward_tasks(fb, n, rt, p, pn, tasks);
+			parallel_for(tasks, [=](int t) {
+				size_t lo = n * t / tasks, hi = n * (t + 1) / tasks;
+				if (square) // (a*R)^2 / R = a^2*R, and one more product with 1/n
+					for (size_t i = lo; i < hi; i++)
+						fa[i] = mont_mul(mont_mul(fa[i], fa[i], p, pn), inv_n, p, pn);
+				else
+					for (size_t i = lo; i < hi; i++)
+						fa[i] = mont_mul(fa[i], fb[i], p, pn);
+			});
+			ntt_inverse_tasks(fa, n, rt, p, pn, tasks);
+		}
+
+		// Garner: x = x1 + p1*(x2 + p2*x3), then carry into 64-bit limbs. Each
+		// task carries through its own stretch of limbs from zero; the carries
+		// left over at the stretch ends are added in afterwards.
+		u64 p1 = primes[0].p, p2 = primes[1].p, p3 = primes[2].p;
+		u64 pn2 = primes[1].pn, pn3 = primes[2].pn;
+		u64 inv12 = mont_mul(ntt_pow(p1 % p2, p2 - 2, p2), primes[1].r2, p2, pn2);
+		u64 inv13 = mont_mul(ntt_pow(p1 % p3, p3 - 2, p3), primes[2].r2, p3, pn3);
+		u64 inv23 = mont_mul(ntt_pow(p2 % p3, p3 - 2, p3), primes[2].r2, p3, pn3);
+		u64 *carries = fb; // two limbs per task
+		parallel_for(tasks, [=](int task) {
+			size_t first = rn * task / tasks, last = rn * (task + 1) / tasks;
+			u64 c0 = 0, c1 = 0; // the carry stays below 2^128
+			for (size_t i = first; i < last; i++)
+			{
+				u64 x1 = res[0][i], x2 = res[1][i], x3 = res[2][i];
+				u64 t = x1 >= p2 ? x1 - p2 : x1;
+				x2 = mont_mul(x2 >= t ? x2 - t : x2 + p2 - t, inv12, p2, pn2);
+				t = x1;
+				while (t >= p3)
+					t -= p3;
+				x3 = mont_mul(x3 >= t ? x3 - t : x3 + p3 - t, inv13, p3, pn3);
+				t = x2 >= p3 ? x2 - p3 : x2;
+				x3 = mont_mul(x3 >= t ? x3 - t : x3 + p3 - t, inv23, p3, pn3);
+
+				__uint128_t y = (__uint128_t)x3 * p2 + x2;
+				__uint128_t lo = (__uint128_t)(u64)y * p1 + x1;
+				__uint128_t hi = (__uint128_t)(u64)(y >> 64) * p1 + (u64)(lo >> 64);
+				__uint128_t s = (__uint128_t)c0 + (u64)lo;
+				rp[i] = (u64)s;
+				s = (s >> 64) + c1 + (u64)hi;
+				c0 = (u64)s;
+				c1 = (u64)(s >> 64) + (u64)(hi >> 64);
+			}
+			carries[2 * task] = c0;
+			carries[2 * task + 1] = c1;
+		});
+		for (int t = 0; t + 1 < tasks; t++)
+			limbs_add_at(rp, (int)rn, (int)(rn * (t + 1) / tasks), carries + 2 * t, 2);
+		scratch_release(mark);
+	}
+
+	// rp[0..2n) = ap[0..n) * bp[0..n)
+	static void mul_n(u64 *rp, const u64 *ap, const u64 *bp, int n, u64 *scratch)
+	{
+		if (n < KARATSUBA_THRESHOLD)
+			mul_basecase(rp, ap, n, bp, n);
+		else if (n < TOOM3_THRESHOLD)
+			mul_karatsuba(rp, ap, bp, n, scratch);
+		else if (n < NTT_THRESHOLD)
+			mul_toom3(rp, ap, bp, n, scratch);
+		else
+			mul_ntt(rp, ap, n, bp, n);
+	}
+
+	static int mul_itch(int an, int bn)
+	{
+		if (bn < KARATSUBA_THRESHOLD || bn >= NTT_THRESHOLD)
+			return 0;
+		int r = an % bn;
+		int sub = mul_n_itch(bn);
+		int rem = r ? mul_itch(bn > r ? bn : r, bn > r ? r : bn) : 0;
+		return 2 * bn + (sub > rem ? sub : rem);
+	}
+
+	// rp[0..an+bn) = ap * bp for an >= bn. Unbalanced operands are cut into
+	// bn-limb blocks of a, each multiplied with the balanced tiers; the NTT
+	// takes unbalanced operands as they are.
+	static void mul_limbs(u64 *rp, const u64 *ap, int an, const u64 *bp, int bn, u64 *scratch)
+	{
+		if (bn < KARATSUBA_THRESHOLD)
+		{
+			mul_basecase(rp, ap, an, bp, bn);
+			return;
+		}
+		if (bn >= NTT_THRESHOLD)
+		{
+			mul_ntt(rp, ap, an, bp, bn);
+			return;
+		}
+		u64 *tmp = scratch, *next = scratch + 2 * bn;
+		mul_n(rp, ap, bp, bn, next);
+		memset(rp + 2 * bn, 0, (an - bn) * sizeof(u64));
+		int i = bn;
+		for (; i + bn <= an; i += bn)
+		{
+			mul_n(tmp, ap + i, bp, bn, next);
+			limbs_add_at(rp, an + bn, i, tmp, 2 * bn);
+		}
+		if (i < an)
+		{
+			int r = an - i;
+			if (r >= bn)
+				mul_limbs(tmp, ap + i, r, bp, bn, next);
+			else
+				mul_limbs(tmp, bp, bn, ap + i, r, next);
+			limbs_add_at(rp, an + bn, i, tmp, r + bn);
+		}
+	}
+
+	static void limbs_sqr(u64 *rp, const u64 *ap, int n);
+
+	// rp[0..an+bn) = ap * bp in either operand order, rp must not overlap
+	static void limbs_mul(u64 *rp, const u64 *ap, int an, const u64 *bp, int bn)
+	{
+		if (ap == bp && an == bn)
+		{
+			limbs_sqr(rp, ap, an);
+			return;
+		}
+		if (an < bn)
+		{
+			const u64 *t = ap;
+			ap = bp;
+			bp = t;
+			int tn = an;
+			an = bn;
+			bn = tn;
+		}
+		int itch = mul_itch(an, bn);
+		BigIntArenaMark mark = scratch_mark();
+		mul_limbs(rp, ap, an, bp, bn, itch > 0 ? scratch_alloc(itch) : NULL);
+		scratch_release(mark);
+	}
+
+	// rp[0..w) = ap * bp mod B^w, rp must not overlap. Short operands skip
+	// the rows and columns that only feed limbs at or above w.
+	static void limbs_mullo(u64 *rp, const u64 *ap, int an, const u64 *bp, int bn, int w)
+	{
+		if (an > w)
+			an = w;
+		if (bn > w)
+			bn = w;
+		if (an >= KARATSUBA_THRESHOLD && bn >= KARATSUBA_THRESHOLD)
+		{
+			BigIntArenaMark mark = scratch_mark();
+			u64 *tp = scratch_alloc(an + bn);
+			limbs_mul(tp, ap, an, bp, bn);
+			int n = an + bn < w ? an + bn : w;
+			memcpy(rp, tp, n * sizeof(u64));
+			memset(rp + n, 0, (w - n) * sizeof(u64));
+			scratch_release(mark);
+			return;
+		}
+		for (int i = 0; i < an; i++)
+		{
+			int len = bn < w - i ? bn : w - i;
+			u64 carry = i ? limbs_addmul_1(rp + i, bp, len, ap[i]) : limbs_mul_1(rp, bp, len, ap[0]);
+			if (i + len < w)
+				rp[i + len] = carry;
+		}
+		if (an + bn < w)
+			memset(rp + an + bn, 0, (w - an - bn) * sizeof(u64));
+	}
+
+	void bigint_square(const BigInt *a, BigInt *result);
+
+	void bigint_multiply(const BigInt *a, const BigInt *b, BigInt *result)
+	{
+		if (a == b)
+		{
+			bigint_square(a, result);
+			return;
+		}
+		if (a->size == 0 || b->size == 0 || (a->size == 1 && a->limbs[0] == 0) || (b->size == 1 && b->limbs[0] == 0))
+		{
+			bigint_reserve(result, 1);
+			result->limbs[0] = 0;
+			result->size = 1;
+			result->sign = 0;
+			return;
+		}
+
+		int result_size = a->size + b->size;
+		int sign = (a->sign == b->sign) ? 1 : -1;
+		// The output may alias an input, in which case it is built aside
+		if (result == a || result == b)
+		{
+			BigIntArenaMark mark = scratch_mark();
+			u64 *rp = scratch_alloc(result_size);
+			limbs_mul(rp, a->limbs, a->size, b->limbs, b->size);
+			bigint_reserve(result, result_size);
+			memcpy(result->limbs, rp, result_size * sizeof(u64));
+			scratch_release(mark);
+		}
+		else
+		{
+			bigint_reserve(result, result_size);
+			limbs_mul(result->limbs, a->limbs, a->size, b->limbs, b->size);
+		}
+		result->size = result_size;
+		result->sign = sign;
+
+		while (result->size > 1 && result->limbs[result->size - 1] == 0)
+			result->size--;
+	}
+
+	// ---------- Squaring ----------
+	// The same tiers as multiplication, each exploiting a == b: the schoolbook
+	// loop forms every cross product once and doubles them, Karatsuba and
+	// Toom-3 recurse on three and five squares, and the NTT transforms the
+	// operand once. Very short operands stay on the multiply loop, where the
+	// doubling and diagonal passes do not pay off yet.
+#define SQR_BASECASE_THRESHOLD tuning[TUNE_SQR_BASECASE]
+#define SQR_KARATSUBA_THRESHOLD tuning[TUNE_SQR_KARATSUBA]
+#define SQR_TOOM3_THRESHOLD tuning[TUNE_SQR_TOOM3]
+#define SQR_NTT_THRESHOLD tuning[TUNE_SQR_NTT]
+
+	// rp[0..2n) = ap^2, rp must not overlap ap
+	static void sqr_basecase(u64 *rp, const u64 *ap, int n)
+	{
+		// Cross products a_i*a_j for i < j, doubled with a one-bit shift
+		rp[0] = 0;
+		if (n > 1)
+		{
+			rp[n] = limbs_mul_1(rp + 1, ap + 1, n - 1, ap[0]);
+			for (int i = 1; i < n - 1; i++)
+				rp[n + i] = limbs_addmul_1(rp + 2 * i + 1, ap + i + 1, n - i - 1, ap[i]);
+		}
+		rp[2 * n - 1] = limbs_lshift(rp, rp, 2 * n - 1, 1);
+
+		// Diagonal terms a_i^2
+		u64 carry = 0;
+		for (int i = 0; i < n; i++)
+		{
+			__uint128_t sq = (__uint128_t)ap[i] * ap[i];
+			__uint128_t sum = (__uint128_t)rp[2 * i] + (u64)sq + carry;
+			rp[2 * i] = (u64)sum;
+			sum = (sum >> 64) + rp[2 * i + 1] + (u64)(sq >> 64);
+			rp[2 * i + 1] = (u64)sum;
+			carry = (u64)(sum >> 64);
+		}
+	}
+
+	static int sqr_n_itch(int n)
+	{
+		if (n < SQR_KARATSUBA_THRESHOLD || n >= SQR_NTT_THRESHOLD)
+			return 0;
+		if (n < SQR_TOOM3_THRESHOLD)
+		{
+			int l = n - n / 2;
+			int sub = sqr_n_itch(l);
+			int sub_h = sqr_n_itch(n / 2);
+			return 4 * l + 1 + (sub > sub_h ? sub : sub_h);
+		}
+		int k = (n + 2) / 3, w = 2 * k + 2;
+		int sub = sqr_n_itch(k + 1);
+		int sub_k = sqr_n_itch(k), sub_s = sqr_n_itch(n - 2 * k);
+		if (sub_k > sub)
+			sub = sub_k;
+		if (sub_s > sub)
+			sub = sub_s;
+		return k + 1 + 3 * w + sub;
+	}
+
+	// a^2 = z0 + (z0 + z2 - (a0-a1)^2)*B^l + z2*B^2l
+	static void sqr_karatsuba(u64 *rp, const u64 *ap, int n, u64 *scratch)
+	{
+		int h = n / 2, l = n - h;
+		u64 *zm = scratch, *da = scratch + 2 * l, *next = scratch + 4 * l + 1;
+
+		limbs_abs_diff(da, ap, l, ap + l, h);
+		sqr_n(zm, da, l, next);
+		sqr_n(rp, ap, l, next);
+		sqr_n(rp + 2 * l, ap + l, h, next);
+
+		// t = z0 + z2 - zm, spanning 2l+1 limbs (reuses da)
+		u64 *t = da;
+		memcpy(t, rp, 2 * l * sizeof(u64));
+		t[2 * l] = 0;
+		limbs_add_at(t, 2 * l + 1, 0, rp + 2 * l, 2 * h);
+		t[2 * l] -= limbs_sub_n(t, t, zm, 2 * l);
+		limbs_add_at(rp, 2 * n, l, t, 2 * l + 1);
+	}
+
+	static void sqr_toom3(u64 *rp, const u64 *ap, int n, u64 *scratch)
+	{
+		int k = (n + 2) / 3, s = n - 2 * k, w = 2 * k + 2;
+		if (n >= MUL_THREAD_THRESHOLD && bigint_get_threads() > 1)
+		{
+			toom3_parallel(rp, ap, NULL, n, sqr_n_itch(n) - (k + 1) - 3 * w);
+			return;
+		}
+		u64 *ea = scratch;
+		u64 *v1 = ea + k + 1, *vm1 = v1 + w, *v2 = vm1 + w, *next = v2 + w;
+
+		toom3_eval(ea, ap, k, s, 1);
+		sqr_n(v1, ea, k + 1, next);
+		toom3_eval(ea, ap, k, s, -1); // the sign squares away
+		sqr_n(vm1, ea, k + 1, next);
+		toom3_eval(ea, ap, k, s, 2);
+		sqr_n(v2, ea, k + 1, next);
+
+		sqr_n(rp, ap, k, next);                 // v0
+		sqr_n(rp + 4 * k, ap + 2 * k, s, next); // vinf
+		toom3_interpolate(rp, n, k, s, v1, vm1, v2);
+	}
+
+	// rp[0..2n) = ap[0..n)^2
+	static void sqr_n(u64 *rp, const u64 *ap, int n, u64 *scratch)
+	{
+		if (n < SQR_BASECASE_THRESHOLD)
+			mul_basecase(rp, ap, n, ap, n);
+		else if (n < SQR_KARATSUBA_THRESHOLD)
+			sqr_basecase(rp, ap, n);
+		else if (n < SQR_TOOM3_THRESHOLD)
+			sqr_karatsuba(rp, ap, n, scratch);
+		else if (n < SQR_NTT_THRESHOLD)
+			sqr_toom3(rp, ap, n, scratch);
+		else
+			mul_ntt(rp, ap, n, ap, n);
+	}
+
+	// rp[0..2n) = ap^2, rp must not overlap
+	static void limbs_sqr(u64 *rp, const u64 *ap, int n)
+	{
+		int itch = sqr_n_itch(n);
+		BigIntArenaMark mark = scratch_mark();
+		sqr_n(rp, ap, n, itch > 0 ? scratch_alloc(itch) : NULL);
+		scratch_release(mark);
+	}
+
+	void bigint_square(const BigInt *a, BigInt *result)
+	{
+		if (a->size == 0 || (a->size == 1 && a->limbs[0] == 0))
+		{
+			bigint_reserve(result, 1);
+			result->limbs[0] = 0;
+			result->size = 1;
+			result->sign = 0;
+			return;
+		}
+
+		int n = a->size, result_size = 2 * n;
+		if (result == a)
+		{
+			BigIntArenaMark mark = scratch_mark();
+			u64 *rp = scratch_alloc(result_size);
+			limbs_sqr(rp, a->limbs, n);
+			bigint_reserve(result, result_size);
+			memcpy(result->limbs, rp, result_size * sizeof(u64));
+			scratch_release(mark);
+		}
+		else
+		{
+			bigint_reserve(result, result_size);
+			limbs_sqr(result->limbs, a->limbs, n);
+		}
+		result->size = result_size;
+		result->sign = 1;
+
+		while (result->size > 1 && result->limbs[result->size - 1] == 0)
+			result->size--;
+	}
+
+	// ---------- Batched Arithmetic ----------
+	// Throughput API for many independent fixed-width numbers. A BigIntBatch
+	// holds `count` non-negative values of `width` limbs each, interleaved in
+	// blocks of BATCH_LANES numbers: limb i of number j lives at
+	//   limbs[(j / BATCH_LANES) * width * BATCH_LANES + i * BATCH_LANES + j % BATCH_LANES]
+	// so one vector load fetches the same limb of eight numbers and the carry
+	// chains of all eight advance together. Add, subtract and compare run
+	// across lanes with AVX2 or AVX-512; products use AVX-512 IFMA on 52-bit
+	// digits where available and the limb kernels one lane at a time
+	// otherwise (AVX2 has no 64-bit multiply worth using). Sums and
+	// differences wrap modulo 2^(64*width) and report the carry or borrow
+	// out of each number; products are exact.
+#define BATCH_LANES 8
+
+	typedef struct
+	{
+		u64 *limbs;
+		size_t count;
+		int width;
+	} BigIntBatch;
+
+	static void batch_store_flags(unsigned char *flags, size_t g, size_t count, const u64 *c)
+	{
+		if (!flags)
+			return;
+		for (size_t l = 0; l < BATCH_LANES && g + l < count; l++)
+			flags[g + l] = c[l] != 0;
+	}
+
+	static void batch_store_cmp(int *result, size_t g, size_t count, const int *r)
+	{
+		for (size_t l = 0; l < BATCH_LANES && g + l < count; l++)
+			result[g + l] = r[l];
+	}
+
+	static void batch_add_generic(u64 *rp, const u64 *ap, const u64 *bp, size_t count, int w, unsigned char *carry)
+	{
+		for (size_t g = 0; g < count; g += BATCH_LANES)
+		{
+			u64 c[BATCH_LANES] = {0};
+			for (int i = 0; i < w; i++, rp += BATCH_LANES, ap += BATCH_LANES, bp += BATCH_LANES)
+				for (int l = 0; l < BATCH_LANES; l++)
+				{
+					u64 s = ap[l] + bp[l], c1 = s < ap[l];
+					s += c[l];
+					c[l] = c1 | (s < c[l]);
+					rp[l] = s;
+				}
+			batch_store_flags(carry, g, count, c);
+		}
+	}
+
+	static void batch_sub_generic(u64 *rp, const u64 *ap, const u64 *bp, size_t count, int w, unsigned char *borrow)
+	{
+		for (size_t g = 0; g < count; g += BATCH_LANES)
+		{
+			u64 c[BATCH_LANES] = {0};
+			for (int i = 0; i < w; i++, rp += BATCH_LANES, ap += BATCH_LANES, bp += BATCH_LANES)
+				for (int l = 0; l < BATCH_LANES; l++)
+				{
+					u64 d = ap[l] - bp[l], b1 = ap[l] < bp[l];
+					rp[l] = d - c[l];
+					c[l] = b1 | (d < c[l]);
+				}
+			batch_store_flags(borrow, g, count, c);
+		}
+	}
+
+	static void batch_cmp_generic(const u64 *ap, const u64 *bp, size_t count, int w, int *result)
+	{
+		for (size_t g = 0; g < count; g += BATCH_LANES, ap += (size_t)w * BATCH_LANES, bp += (size_t)w * BATCH_LANES)
+		{
+			int r[BATCH_LANES] = {0};
+			for (int i = w - 1; i >= 0; i--)
+				for (int l = 0; l < BATCH_LANES; l++)
+				{
+					u64 x = ap[i * BATCH_LANES + l], y = bp[i * BATCH_LANES + l];
+					if (!r[l])
+						r[l] = (x > y) - (x < y);
+				}
+			batch_store_cmp(result, g, count, r);
+		}
+	}
+
+	// One lane at a time through the basecase product
+	static void batch_mul_generic(u64 *rp, const u64 *ap, int wa, const u64 *bp, int wb, size_t count)
+	{
+		int wr = wa + wb;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *x = scratch_alloc(2 * (size_t)wr), *y = x + wa, *z = y + wb;
+		for (size_t g = 0; g < count; g += BATCH_LANES)
+		{
+			for (size_t l = 0; l < BATCH_LANES && g + l < count; l++)
+			{
+				for (int i = 0; i < wa; i++)
+					x[i] = ap[i * BATCH_LANES + l];
+				for (int i = 0; i < wb; i++)
+					y[i] = bp[i * BATCH_LANES + l];
+				mul_basecase(z, x, wa, y, wb);
+				for (int i = 0; i < wr; i++)
+					rp[i * BATCH_LANES + l] = z[i];
+			}
+			ap += (size_t)wa * BATCH_LANES;
+			bp += (size_t)wb * BATCH_LANES;
+			rp += (size_t)wr * BATCH_LANES;
+		}
+		scratch_release(mark);
+	}
+
+#if BIGINT_X86_64_ASM
+	// ---- AVX2: two vectors of four lanes per limb row ----
+	// AVX2 compares are signed only, so both sides get the sign bit flipped
+	// before an unsigned comparison. Carries travel as all-ones masks.
+	__attribute__((target("avx2"))) static inline __m256i batch_lt_avx2(__m256i x, __m256i y)
+	{
+		const __m256i sign = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+		return _mm256_cmpgt_epi64(_mm256_xor_si256(y, sign), _mm256_xor_si256(x, sign));
+	}
+
+	__attribute__((target("avx2"))) static void batch_add_avx2(u64 *rp, const u64 *ap, const u64 *bp, size_t count, int w, unsigned char *carry)
+	{
+		for (size_t g = 0; g < count; g += BATCH_LANES)
+		{
+			__m256i c[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+			for (int i = 0; i < w; i++, rp += BATCH_LANES, ap += BATCH_LANES, bp += BATCH_LANES)
+				for (int h = 0; h < 2; h++)
+				{
+					__m256i x = _mm256_loadu_si256((const __m256i *)(ap + 4 * h));
+					__m256i y = _mm256_loadu_si256((const __m256i *)(bp + 4 * h));
+					__m256i s = _mm256_add_epi64(x, y), t = _mm256_sub_epi64(s, c[h]);
+					c[h] = _mm256_or_si256(batch_lt_avx2(s, x), batch_lt_avx2(t, s));
+					_mm256_storeu_si256((__m256i *)(rp + 4 * h), t);
+				}
+			u64 flags[BATCH_LANES];
+			_mm256_storeu_si256((__m256i *)flags, c[0]);
+			_mm256_storeu_si256((__m256i *)(flags + 4), c[1]);
+			batch_store_flags(carry, g, count, flags);
+		}
+	}
+
+	__attribute__((target("avx2"))) static void batch_sub_avx2(u64 *rp, const u64 *ap, const u64 *bp, size_t count, int w, unsigned char *borrow)
+	{
+		for (size_t g = 0; g < count; g += BATCH_LANES)
+		{
+			__m256i c[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+			for (int i = 0; i < w; i++, rp += BATCH_LANES, ap += BATCH_LANES, bp += BATCH_LANES)
+				for (int h = 0; h < 2; h++)
+				{
+					__m256i x = _mm256_loadu_si256((const __m256i *)(ap + 4 * h));
+					__m256i y = _mm256_loadu_si256((const __m256i *)(bp + 4 * h));
+					__m256i d = _mm256_sub_epi64(x, y), t = _mm256_add_epi64(d, c[h]);
+					c[h] = _mm256_or_si256(batch_lt_avx2(x, y), batch_lt_avx2(d, t));
+					_mm256_storeu_si256((__m256i *)(rp + 4 * h), t);
+				}
+			u64 flags[BATCH_LANES];
+			_mm256_storeu_si256((__m256i *)flags, c[0]);
+			_mm256_storeu_si256((__m256i *)(flags + 4), c[1]);
+			batch_store_flags(borrow, g, count, flags);
+		}
+	}
+
+	// Scans from the top limb and stops once every lane has differed
+	__attribute__((target("avx2"))) static void batch_cmp_avx2(const u64 *ap, const u64 *bp, size_t count, int w, int *result)
+	{
+		for (size_t g = 0; g < count; g += BATCH_LANES, ap += (size_t)w * BATCH_LANES, bp += (size_t)w * BATCH_LANES)
+		{
+			__m256i gt[2], lt[2];
+			for (int h = 0; h < 2; h++)
+				gt[h] = lt[h] = _mm256_setzero_si256();
+			for (int i = w - 1; i >= 0; i--)
+			{
+				int decided = 1;
+				for (int h = 0; h < 2; h++)
+				{
+					__m256i x = _mm256_loadu_si256((const __m256i *)(ap + i * BATCH_LANES + 4 * h));
+					__m256i y = _mm256_loadu_si256((const __m256i *)(bp + i * BATCH_LANES + 4 * h));
+					__m256i open = _mm256_or_si256(gt[h], lt[h]);
+					gt[h] = _mm256_or_si256(gt[h], _mm256_andnot_si256(open, batch_lt_avx2(y, x)));
+					lt[h] = _mm256_or_si256(lt[h], _mm256_andnot_si256(open, batch_lt_avx2(x, y)));
+					decided &= _mm256_movemask_epi8(_mm256_or_si256(gt[h], lt[h])) == -1;
+				}
+				if (decided)
+					break;
+			}
+			u64 g64[BATCH_LANES], l64[BATCH_LANES];
+			int r[BATCH_LANES];
+			for (int h = 0; h < 2; h++)
+			{
+				_mm256_storeu_si256((__m256i *)(g64 + 4 * h), gt[h]);
+				_mm256_storeu_si256((__m256i *)(l64 + 4 * h), lt[h]);
+			}
+			for (int l = 0; l < BATCH_LANES; l++)
+				r[l] = (g64[l] != 0) - (l64[l] != 0);
+			batch_store_cmp(result, g, count, r);
+		}
+	}
+
+	// ---- AVX-512: one vector of eight lanes per limb row ----
+	__attribute__((target("avx512f"))) static void batch_add_avx512(u64 *rp, const u64 *ap, const u64 *bp, size_t count, int w, unsigned char *carry)
+	{
+		const __m512i one = _mm512_set1_epi64(1);
+		for (size_t g = 0; g < count; g += BATCH_LANES)
+		{
+			__mmask8 c = 0;
+			for (int i = 0; i < w; i++, rp += BATCH_LANES, ap += BATCH_LANES, bp += BATCH_LANES)
+			{
+				__m512i x = _mm512_loadu_si512(ap), y = _mm512_loadu_si512(bp);
+				__m512i s = _mm512_add_epi64(x, y);
+				__mmask8 c1 = _mm512_cmplt_epu64_mask(s, x);
+				__m512i t = _mm512_mask_add_epi64(s, c, s, one);
+				c = c1 | _mm512_mask_cmplt_epu64_mask(c, t, s);
+				_mm512_storeu_si512(rp, t);
+			}
+			u64 flags[BATCH_LANES];
+			for (int l = 0; l < BATCH_LANES; l++)
+				flags[l] = c >> l & 1;
+			batch_store_flags(carry, g, count, flags);
+		}
+	}
+
+	__attribute__((target("avx512f"))) static void batch_sub_avx512(u64 *rp, const u64 *ap, const u64 *bp, size_t count, int w, unsigned char *borrow)
+	{
+		const __m512i one = _mm512_set1_epi64(1);
+		for (size_t g = 0; g < count; g += BATCH_LANES)
+		{
+			__mmask8 c = 0;
+			for (int i = 0; i < w; i++, rp += BATCH_LANES, ap += BATCH_LANES, bp += BATCH_LANES)
+			{
+				__m512i x = _mm512_loadu_si512(ap), y = _mm512_loadu_si512(bp);
+				__m512i d = _mm512_sub_epi64(x, y);
+				__mmask8 b1 = _mm512_cmplt_epu64_mask(x, y);
+				__mmask8 b2 = _mm512_mask_cmpeq_epu64_mask(c, d, _mm512_setzero_si512());
+				_mm512_storeu_si512(rp, _mm512_mask_sub_epi64(d, c, d, one));
+				c = b1 | b2;
+			}
+			u64 flags[BATCH_LANES];
+			for (int l = 0; l < BATCH_LANES; l++)
+				flags[l] = c >> l & 1;
+			batch_store_flags(borrow, g, count, flags);
+		}
+	}
+
+	__attribute__((target("avx512f"))) static void batch_cmp_avx512(const u64 *ap, const u64 *bp, size_t count, int w, int *result)
+	{
+		for (size_t g = 0; g < count; g += BATCH_LANES, ap += (size_t)w * BATCH_LANES, bp += (size_t)w * BATCH_LANES)
+		{
+			__mmask8 gt = 0, lt = 0;
+			for (int i = w - 1; i >= 0 && (__mmask8)(gt | lt) != 0xFF; i--)
+			{
+				__m512i x = _mm512_loadu_si512(ap + i * BATCH_LANES), y = _mm512_loadu_si512(bp + i * BATCH_LANES);
+				__mmask8 open = ~(gt | lt);
+				gt |= _mm512_mask_cmpgt_epu64_mask(open, x, y);
+				lt |= _mm512_mask_cmplt_epu64_mask(open, x, y);
+			}
+			int r[BATCH_LANES];
+			for (int l = 0; l < BATCH_LANES; l++)
+				r[l] = (gt >> l & 1) - (lt >> l & 1);
+			batch_store_cmp(result, g, count, r);
+		}
+	}
+
+	// Products on 52-bit digits: vpmadd52luq/vpmadd52huq add the low and high
+	// halves of a 104-bit digit product to a 64-bit accumulator, so a column
+	// sums without carries and is normalized once. The operands are re-cut
+	// from 64-bit limbs into digits and the result cut back.
+// Digit products summed into one lane between folds of its high bits; the
+// lane holds 4096 halves below 2^52, so 1024 leaves room for the carry in
+#define BATCH_IFMA_CHUNK 1024
+	// Lane shifts by a run-time count. The masked forms with a full mask take
+	// zero as their passthrough; the plain ones pass _mm512_undefined_epi32(),
+	// which GCC 12 reports as maybe-uninitialized wherever they are inlined.
+	__attribute__((target("avx512f"))) static inline __m512i batch_shr(__m512i x, int n)
+	{
+		return _mm512_maskz_srlv_epi64(0xff, x, _mm512_set1_epi64(n));
+	}
+
+	__attribute__((target("avx512f"))) static inline __m512i batch_shl(__m512i x, int n)
+	{
+		return _mm512_maskz_sllv_epi64(0xff, x, _mm512_set1_epi64(n));
+	}
+
+	__attribute__((target("avx512f"))) static void batch_to_digits(u64 *dp, int d, const u64 *ap, int w)
+	{
+		const __m512i mask = _mm512_set1_epi64((1LL << 52) - 1);
+		for (int k = 0; k < d; k++)
+		{
+			int q = 52 * k / 64, r = 52 * k % 64;
+			__m512i v = batch_shr(_mm512_loadu_si512(ap + q * BATCH_LANES), r);
+			if (r > 12 && q + 1 < w)
+				v = _mm512_or_si512(v, batch_shl(_mm512_loadu_si512(ap + (q + 1) * BATCH_LANES), 64 - r));
+			_mm512_storeu_si512(dp + k * BATCH_LANES, _mm512_and_si512(v, mask));
+		}
+	}
+
+	__attribute__((target("avx512f,avx512ifma"))) static void batch_mul_ifma(u64 *rp, const u64 *ap, int wa, const u64 *bp, int wb, size_t count)
+	{
+		int wr = wa + wb, da = (64 * wa + 51) / 52, db = (64 * wb + 51) / 52;
+		const __m512i mask = _mm512_set1_epi64((1LL << 52) - 1);
+		BigIntArenaMark mark = scratch_mark();
+		u64 *xa = scratch_alloc((size_t)(da + db) * BATCH_LANES), *xb = xa + da * BATCH_LANES;
+		for (size_t g = 0; g < count; g += BATCH_LANES)
+		{
+			batch_to_digits(xa, da, ap, wa);
+			batch_to_digits(xb, db, bp, wb);
+			memset(rp, 0, (size_t)wr * BATCH_LANES * sizeof(u64));
+
+			// Column k: low halves of the products a_i*b_(k-i) and high halves
+			// of a_i*b_(k-1-i), on top of the carry from column k-1. Every
+			// BATCH_IFMA_CHUNK halves the bits above the digit move from t to
+			// over, so wide operands cannot overflow the 64-bit lane.
+			__m512i carry = _mm512_setzero_si512();
+			for (int k = 0; 52 * k < 64 * wr; k++)
+			{
+				__m512i t = carry, over = _mm512_setzero_si512();
+				int first = k - db + 1 > 0 ? k - db + 1 : 0, last = k + 1 < da ? k + 1 : da;
+				for (int c = first; c < last; c += BATCH_IFMA_CHUNK)
+				{
+					for (int i = c; i < last && i < c + BATCH_IFMA_CHUNK; i++)
+						t = _mm512_madd52lo_epu64(t, _mm512_loadu_si512(xa + i * BATCH_LANES), _mm512_loadu_si512(xb + (k - i) * BATCH_LANES));
+					over = _mm512_add_epi64(over, batch_shr(t, 52));
+					t = _mm512_and_si512(t, mask);
+				}
+				first = k - db > 0 ? k - db : 0;
+				last = k < da ? k : da;
+				for (int c = first; c < last; c += BATCH_IFMA_CHUNK)
+				{
+					for (int i = c; i < last && i < c + BATCH_IFMA_CHUNK; i++)
+						t = _mm512_madd52hi_epu64(t, _mm512_loadu_si512(xa + i * BATCH_LANES), _mm512_loadu_si512(xb + (k - 1 - i) * BATCH_LANES));
+					over = _mm512_add_epi64(over, batch_shr(t, 52));
+					t = _mm512_and_si512(t, mask);
+				}
+				__m512i digit = _mm512_and_si512(t, mask);
+				carry = _mm512_add_epi64(batch_shr(t, 52), over);
+
+				int q = 52 * k / 64, r = 52 * k % 64;
+				u64 *lo = rp + q * BATCH_LANES;
+				_mm512_storeu_si512(lo, _mm512_or_si512(_mm512_loadu_si512(lo), batch_shl(digit, r)));
+				if (r > 12 && q + 1 < wr)
+				{
+					u64 *hi = lo + BATCH_LANES;
+					_mm512_storeu_si512(hi, batch_shr(digit, 64 - r));
+				}
+			}
+			ap += (size_t)wa * BATCH_LANES;
+			bp += (size_t)wb * BATCH_LANES;
+			rp += (size_t)wr * BATCH_LANES;
+		}
+		scratch_release(mark);
+	}
+#endif
+
+	typedef struct
+	{
+		void (*add)(u64 *, const u64 *, const u64 *, size_t, int, unsigned char *);
+		void (*sub)(u64 *, const u64 *, const u64 *, size_t, int, unsigned char *);
+		void (*mul)(u64 *, const u64 *, int, const u64 *, int, size_t);
+		void (*cmp)(const u64 *, const u64 *, size_t, int, int *);
+		const char *name;
+	} BatchKernels;
+
+	static BatchKernels batch_kernels = {batch_add_generic, batch_sub_generic, batch_mul_generic, batch_cmp_generic, "generic"};
+
+	static int batch_select_kernels(void)
+	{
+#if BIGINT_X86_64_ASM
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+		{
+			batch_kernels.add = batch_add_avx2;
+			batch_kernels.sub = batch_sub_avx2;
+			batch_kernels.cmp = batch_cmp_avx2;
+			batch_kernels.name = "avx2";
+		}
+		if (__builtin_cpu_supports("avx512f"))
+		{
+			batch_kernels.add = batch_add_avx512;
+			batch_kernels.sub = batch_sub_avx512;
+			batch_kernels.cmp = batch_cmp_avx512;
+			batch_kernels.name = "avx512";
+			if (__builtin_cpu_supports("avx512ifma"))
+			{
+				batch_kernels.mul = batch_mul_ifma;
+				batch_kernels.name = "avx512 ifma";
+			}
+		}
+#endif
+		return 1;
+	}
+	static int batch_kernels_selected = batch_select_kernels();
+
+	// Name of the batch kernel set picked for this CPU
+	const char *bigint_batch_kernels(void)
+	{
+		return batch_kernels.name;
+	}
+
+	static void batch_check(int ok, const char *what)
+	{
+		if (!ok)
+		{
+			fprintf(stderr, "Error: %s\n", what);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	// Room for `count` zeros of `width` limbs each
+	void bigint_batch_init(BigIntBatch *batch, size_t count, int width)
+	{
+		batch_check(width > 0, "batch width must be positive in bigint_batch_init");
+		size_t groups = (count + BATCH_LANES - 1) / BATCH_LANES;
+		size_t bytes = (groups ? groups : 1) * width * BATCH_LANES * sizeof(u64);
+		batch->limbs = (u64 *)aligned_alloc(64, bytes);
+		if (!batch->limbs)
+		{
+			fprintf(stderr, "Memory allocation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		memset(batch->limbs, 0, bytes);
+		batch->count = count;
+		batch->width = width;
+	}
+
+	void bigint_batch_free(BigIntBatch *batch)
+	{
+		free(batch->limbs);
+		batch->limbs = NULL;
+		batch->count = 0;
+	}
+
+	static u64 *batch_slot(const BigIntBatch *batch, size_t index)
+	{
+		batch_check(index < batch->count, "batch index out of range");
+		return batch->limbs + index / BATCH_LANES * batch->width * BATCH_LANES + index % BATCH_LANES;
+	}
+
+	// Stores a non-negative value that fits in the batch width
+	void bigint_batch_set(BigIntBatch *batch, size_t index, const BigInt *value)
+	{
+		batch_check(value->sign >= 0 && value->size <= batch->width, "value does not fit in bigint_batch_set");
+		u64 *slot = batch_slot(batch, index);
+		for (int i = 0; i < batch->width; i++)
+			slot[i * BATCH_LANES] = i < value->size ? value->limbs[i] : 0;
+	}
+
+	void bigint_batch_get(const BigIntBatch *batch, size_t index, BigInt *value)
+	{
+		const u64 *slot = batch_slot(batch, index);
+		int n = batch->width;
+		while (n > 0 && slot[(n - 1) * BATCH_LANES] == 0)
+			n--;
+		if (n == 0)
+		{
+			bigint_reserve(value, 1);
+			value->limbs[0] = 0;
+			value->size = 1;
+			value->sign = 0;
+			return;
+		}
+		bigint_reserve(value, n);
+		for (int i = 0; i < n; i++)
+			value->limbs[i] = slot[i * BATCH_LANES];
+		value->size = n;
+		value->sign = 1;
+	}
+
+	// result[j] = a[j] + b[j] mod 2^(64*width) for every j; carry[j] (if
+	// given) receives the bit carried out. result may be a or b.
+	void bigint_batch_add(const BigIntBatch *a, const BigIntBatch *b, BigIntBatch *result, unsigned char *carry)
+	{
+		batch_check(a->count == b->count && a->count == result->count && a->width == b->width && a->width == result->width,
+					"mismatched batches in bigint_batch_add");
+		batch_kernels.add(result->limbs, a->limbs, b->limbs, a->count, a->width, carry);
+	}
+
+	// result[j] = a[j] - b[j] mod 2^(64*width); borrow[j] (if given) is 1
+	// where a[j] < b[j]. result may be a or b.
+	void bigint_batch_subtract(const BigIntBatch *a, const BigIntBatch *b, BigIntBatch *result, unsigned char *borrow)
+	{
+		batch_check(a->count == b->count && a->count == result->count && a->width == b->width && a->width == result->width,
+					"mismatched batches in bigint_batch_subtract");
+		batch_kernels.sub(result->limbs, a->limbs, b->limbs, a->count, a->width, borrow);
+	}
+
+	// result[j] = a[j] * b[j] in full; result is a.width + b.width limbs wide
+	void bigint_batch_multiply(const BigIntBatch *a, const BigIntBatch *b, BigIntBatch *result)
+	{
+		batch_check(a->count == b->count && a->count == result->count && result->width == a->width + b->width,
+					"mismatched batches in bigint_batch_multiply");
+		batch_kernels.mul(result->limbs, a->limbs, a->width, b->limbs, b->width, a->count);
+	}
+
+	// result[j] = -1, 0 or 1 as a[j] is below, equal to or above b[j]
+	void bigint_batch_compare(const BigIntBatch *a, const BigIntBatch *b, int *result)
+	{
+		batch_check(a->count == b->count && a->width == b->width, "mismatched batches in bigint_batch_compare");
+		batch_kernels.cmp(a->limbs, b->limbs, a->count, a->width, result);
+	}
+
+	// ---------- Shift Left ----------
+	void bigint_shift_left(BigInt *num, int bits)
+	{
+		if (bits == 0 || num->size == 0)
+			return;
+
+		int limb_shift = bits / 64;
+		int bit_shift = bits % 64;
+
+		int new_size = num->size + limb_shift + (bit_shift ? 1 : 0);
+		bigint_reserve(num, new_size);
+
+		if (limb_shift > 0)
+		{
+			memmove(num->limbs + limb_shift, num->limbs, num->size * sizeof(u64));
+			memset(num->limbs, 0, limb_shift * sizeof(u64));
+		}
+		if (bit_shift > 0)
+			num->limbs[new_size - 1] = limbs_lshift(num->limbs + limb_shift, num->limbs + limb_shift, num->size, bit_shift);
+		num->size = new_size;
+		while (num->size > 1 && num->limbs[num->size - 1] == 0)
+			num->size--;
+	}
+
+	// ---------- Shift Right ----------
+	// Shifts the magnitude right, dropping the bits shifted out
+	void bigint_shift_right(BigInt *num, int bits)
+	{
+		if (bits == 0 || num->size == 0)
+			return;
+
+		int limb_shift = bits / 64;
+		int bit_shift = bits % 64;
+		if (limb_shift >= num->size)
+		{
+			num->limbs[0] = 0;
+			num->size = 1;
+			num->sign = 1;
+			return;
+		}
+
+		int new_size = num->size - limb_shift;
+		limbs_rshift(num->limbs, num->limbs + limb_shift, new_size, bit_shift);
+		num->size = new_size;
+		while (num->size > 1 && num->limbs[num->size - 1] == 0)
+			num->size--;
+		if (num->size == 1 && num->limbs[0] == 0)
+			num->sign = 1;
+	}
+
+	// ---------- Bitwise Operations ----------
+	// and/or/xor/not act on the two's complement of the value with infinite
+	// sign extension, as in GMP, so -1 is all ones and ~x == -x - 1. The
+	// queries on |a| (bit length, popcount, trailing zeros) ignore the sign.
+	// Non-negative operands are combined limb by limb straight into the
+	// result; a negative one goes through a two's complement copy in the
+	// scratch arena. The result may be either operand.
+
+	static void bigint_assign_limbs(BigInt *dst, const u64 *src, int n, int sign);
+
+	static int bitwise_size(const BigInt *a)
+	{
+		int n = a->size;
+		while (n > 0 && a->limbs[n - 1] == 0)
+			n--;
+		return n;
+	}
+
+	// Number of significant bits of |a|, 0 for zero
+	int bigint_bit_length(const BigInt *a)
+	{
+		int n = bitwise_size(a);
+		return n ? 64 * n - __builtin_clzll(a->limbs[n - 1]) : 0;
+	}
+
+	// Number of one bits in |a|
+	u64 bigint_popcount(const BigInt *a)
+	{
+		u64 count = 0;
+		for (int i = 0; i < a->size; i++)
+			count += __builtin_popcountll(a->limbs[i]);
+		return count;
+	}
+
+	// Index of the lowest one bit, -1 for zero (the same for a and -a)
+	long long bigint_trailing_zeros(const BigInt *a)
+	{
+		for (int i = 0; i < a->size; i++)
+			if (a->limbs[i])
+				return 64LL * i + __builtin_ctzll(a->limbs[i]);
+		return -1;
+	}
+
+	// Bit `bit` of a in two's complement
+	int bigint_test_bit(const BigInt *a, u64 bit)
+	{
+		u64 limb = bit / 64;
+		int set = limb < (u64)a->size && (a->limbs[limb] >> bit % 64 & 1);
+		if (a->sign >= 0)
+			return set;
+		// -m = ~(m - 1): zeros below the lowest one bit of m, that bit itself,
+		// and the complement of m above it
+		long long low = bigint_trailing_zeros(a);
+		if (low < 0 || bit < (u64)low)
+			return 0;
+		return bit == (u64)low ? 1 : !set;
+	}
+
+	// dst[0..n) = the low n limbs of a in two's complement
+	static void bitwise_load(u64 *dst, const BigInt *a, int an, int n)
+	{
+		memcpy(dst, a->limbs, an * sizeof(u64));
+		memset(dst + an, 0, (n - an) * sizeof(u64));
+		if (a->sign < 0)
+		{
+			for (int i = 0; i < n; i++)
+				dst[i] = ~dst[i];
+			limbs_add_1(dst, dst, n, 1);
+		}
+	}
+
+	static void bitwise_op(u64 *rp, const u64 *ap, const u64 *bp, int n, char op)
+	{
+		if (op == '&')
+			for (int i = 0; i < n; i++)
+				rp[i] = ap[i] & bp[i];
+		else if (op == '|')
+			for (int i = 0; i < n; i++)
+				rp[i] = ap[i] | bp[i];
+		else
+			for (int i = 0; i < n; i++)
+				rp[i] = ap[i] ^ bp[i];
+	}
+
+	static void bigint_bitwise(const BigInt *a, const BigInt *b, BigInt *result, char op)
+	{
+		int an = bitwise_size(a), bn = bitwise_size(b);
+		int a_neg = a->sign < 0 && an > 0, b_neg = b->sign < 0 && bn > 0;
+		if (!a_neg && !b_neg)
+		{
+			if (an < bn)
+			{
+				const BigInt *t = a;
+				a = b, b = t;
+				int tn = an;
+				an = bn, bn = tn;
+			}
+			// a is the longer operand; and stops at b's length, or/xor copy a's
+			// top limbs through
+			int n = op == '&' ? bn : an;
+			bigint_reserve(result, n ? n : 1);
+			bitwise_op(result->limbs, a->limbs, b->limbs, bn, op);
+			if (op != '&' && result != a)
+				memcpy(result->limbs + bn, a->limbs + bn, (an - bn) * sizeof(u64));
+			bigint_assign_limbs(result, result->limbs, n, 1);
+			return;
+		}
+
+		int n = (an > bn ? an : bn) + 1;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *x = scratch_alloc(2 * (size_t)n), *y = x + n;
+		bitwise_load(x, a, an, n);
+		bitwise_load(y, b, bn, n);
+		bitwise_op(x, x, y, n, op);
+		int neg = x[n - 1] >> 63;
+		if (neg)
+		{
+			for (int i = 0; i < n; i++)
+				x[i] = ~x[i];
+			limbs_add_1(x, x, n, 1);
+		}
+		bigint_assign_limbs(result, x, n, neg ? -1 : 1);
+		scratch_release(mark);
+	}
+
+	void bigint_and(const BigInt *a, const BigInt *b, BigInt *result)
+	{
+		bigint_bitwise(a, b, result, '&');
+	}
+
+	void bigint_or(const BigInt *a, const BigInt *b, BigInt *result)
+	{
+		bigint_bitwise(a, b, result, '|');
+	}
+
+	void bigint_xor(const BigInt *a, const BigInt *b, BigInt *result)
+	{
+		bigint_bitwise(a, b, result, '^');
+	}
+
+	// result = ~a = -a - 1
+	void bigint_not(const BigInt *a, BigInt *result)
+	{
+		int n = bitwise_size(a);
+		int neg = a->sign < 0 && n > 0;
+		bigint_reserve(result, n + 1);
+		if (result != a)
+			memcpy(result->limbs, a->limbs, n * sizeof(u64));
+		if (neg) // -m - 1 becomes m - 1
+		{
+			limbs_sub_1(result->limbs, result->limbs, n, 1);
+			result->limbs[n] = 0;
+		}
+		else // m becomes -(m + 1)
+			result->limbs[n] = limbs_add_1(result->limbs, result->limbs, n, 1);
+		bigint_assign_limbs(result, result->limbs, n + 1, neg ? 1 : -1);
+	}
+
+	// ---------- Accumulation ----------
+	// A running sum of many BigInts with the carries held back. Column i is
+	// a signed 128-bit total of everything added at limb position i, so an
+	// add touches only its operand's columns and never ripples or
+	// reallocates the sum; the carries are propagated once, by
+	// bigint_acc_result. The value is the sum of cols[i] * 2^(64i).
+	typedef struct
+	{
+		__int128_t *cols;
+		int size;
+		int capacity;
+		u64 pending; // most addends below 2^64 any column has taken since the last carry pass
+	} BigIntAcc;
+
+// A column holds up to this many addends below 2^64 without overflowing
+#define ACC_PENDING_LIMIT (1ULL << 62)
+// Products up to this many limbs are formed on the stack
+#define ACC_STACK_LIMBS 64
+
+	void bigint_acc_init(BigIntAcc *acc)
+	{
+		acc->cols = NULL;
+		acc->size = 0;
+		acc->capacity = 0;
+		acc->pending = 0;
+	}
+
+	void bigint_acc_free(BigIntAcc *acc)
+	{
+		free(acc->cols);
+		bigint_acc_init(acc);
+	}
+
+	// Columns above size are kept zero
+	static void acc_reserve(BigIntAcc *acc, int n)
+	{
+		if (n > acc->capacity)
+		{
+			int capacity = n > 2 * acc->capacity ? n : 2 * acc->capacity;
+			__int128_t *cols = (__int128_t *)realloc(acc->cols, capacity * sizeof(__int128_t));
+			if (!cols)
+			{
+				fprintf(stderr, "Memory allocation failed\n");
+				exit(EXIT_FAILURE);
+			}
+			memset(cols + acc->capacity, 0, (capacity - acc->capacity) * sizeof(__int128_t));
+			acc->cols = cols;
+			acc->capacity = capacity;
+		}
+		if (n > acc->size)
+			acc->size = n;
+	}
+
+	// One carry pass: every column but the top ends in [0, 2^64) and the top
+	// one, which keeps the sign, below 2^64 in magnitude; each then holds the
+	// equivalent of one addend. A new column is added only when the top one
+	// would exceed that.
+	static void acc_carry(BigIntAcc *acc)
+	{
+		int n = acc->size;
+		if (n == 0)
+			return;
+		__int128_t carry = 0;
+		for (int i = 0; i < n - 1; i++)
+		{
+			__int128_t v = acc->cols[i] + carry;
+			acc->cols[i] = (u64)v;
+			carry = v >> 64;
+		}
+		__int128_t top = acc->cols[n - 1] + carry;
+		__int128_t bound = (__int128_t)1 << 64;
+		if (top > -bound && top < bound)
+			acc->cols[n - 1] = top;
+		else
+		{
+			acc->cols[n - 1] = (u64)top;
+			acc_reserve(acc, n + 1);
+			acc->cols[n] = top >> 64;
+		}
+		acc->pending = 1;
+	}
+
+	// Makes room for n columns that each take `addends` more addends
+	static void acc_prepare(BigIntAcc *acc, int n, u64 addends)
+	{
+		if (acc->pending + addends > ACC_PENDING_LIMIT)
+			acc_carry(acc);
+		acc->pending += addends;
+		acc_reserve(acc, n);
+	}
+
+	// cols[i] += sign * p[i] for i < n
+	static void acc_add_limbs(BigIntAcc *acc, const u64 *p, int n, int sign)
+	{
+		acc_prepare(acc, n, 1);
+		__int128_t *cols = acc->cols;
+		if (sign < 0)
+			for (int i = 0; i < n; i++)
+				cols[i] -= p[i];
+		else
+			for (int i = 0; i < n; i++)
+				cols[i] += p[i];
+	}
+
+	// acc += a
+	void bigint_acc_add(BigIntAcc *acc, const BigInt *a)
+	{
+		acc_add_limbs(acc, a->limbs, a->size, a->sign);
+	}
+
+	// cols[i] += sign * p[i] * m for i < n. The high half of each limb
+	// product lands one column up, so nothing is carried here either.
+	static void acc_addmul_limbs(BigIntAcc *acc, const u64 *p, int n, u64 m, int sign)
+	{
+		acc_prepare(acc, n + 1, 2);
+		__int128_t *cols = acc->cols;
+		if (sign < 0)
+			for (int i = 0; i < n; i++)
+			{
+				__uint128_t t = (__uint128_t)p[i] * m;
+				cols[i] -= (u64)t;
+				cols[i + 1] -= (u64)(t >> 64);
+			}
+		else
+			for (int i = 0; i < n; i++)
+			{
+				__uint128_t t = (__uint128_t)p[i] * m;
+				cols[i] += (u64)t;
+				cols[i + 1] += (u64)(t >> 64);
+			}
+	}
+
+	// acc += a * m
+	void bigint_acc_addmul_small(BigIntAcc *acc, const BigInt *a, u64 m)
+	{
+		acc_addmul_limbs(acc, a->limbs, a->size, m, a->sign);
+	}
+
+	// acc += a * b; the product is formed in scratch by the usual tiers
+	void bigint_acc_addmul(BigIntAcc *acc, const BigInt *a, const BigInt *b)
+	{
+		int an = a->size, bn = b->size;
+		int sign = (a->sign < 0) != (b->sign < 0) ? -1 : 1;
+		if (an == 0 || bn == 0)
+			return;
+		if (an == 1 || bn == 1)
+		{
+			if (an == 1)
+				acc_addmul_limbs(acc, b->limbs, bn, a->limbs[0], sign);
+			else
+				acc_addmul_limbs(acc, a->limbs, an, b->limbs[0], sign);
+			return;
+		}
+		if (an + bn <= ACC_STACK_LIMBS)
+		{
+			u64 tp[ACC_STACK_LIMBS];
+			limbs_mul(tp, a->limbs, an, b->limbs, bn);
+			acc_add_limbs(acc, tp, an + bn, sign);
+			return;
+		}
+		BigIntArenaMark mark = scratch_mark();
+		u64 *tp = scratch_alloc(an + bn);
+		limbs_mul(tp, a->limbs, an, b->limbs, bn);
+		acc_add_limbs(acc, tp, an + bn, sign);
+		scratch_release(mark);
+	}
+
+	// acc += a[0] * b[0] + ... + a[count-1] * b[count-1]
+	void bigint_acc_dot(BigIntAcc *acc, const BigInt *a, const BigInt *b, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			bigint_acc_addmul(acc, &a[i], &b[i]);
+	}
+
+	// result = the sum so far; acc keeps it and can take more addends
+	void bigint_acc_result(BigIntAcc *acc, BigInt *result)
+	{
+		acc_carry(acc);
+		int n = acc->size;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *rp = scratch_alloc(n + 1);
+		for (int i = 0; i < n; i++)
+			rp[i] = (u64)acc->cols[i];
+		int sign = 1;
+		if (n > 0 && acc->cols[n - 1] < 0) // two's complement, the top column sign-extended
+		{
+			rp[n] = ~0ULL;
+			for (int i = 0; i <= n; i++)
+				rp[i] = ~rp[i];
+			limbs_add_1(rp, rp, n + 1, 1);
+			sign = -1;
+		}
+		bigint_assign_limbs(result, rp, n, sign);
+		scratch_release(mark);
+	}
+
+	// ---------- Divide by u64 ----------
+	void bigint_divide_u64(const BigInt *input, u64 divisor, BigInt *quotient, u64 *remainder)
+	{
+		if (divisor == 0)
+		{
+			fprintf(stderr, "Error: division by zero in bigint_divide_u64\n");
+			exit(EXIT_FAILURE);
+		}
+	
+		// Fast path: divisor is 1
+		if (divisor == 1)
+		{
+			bigint_copy(quotient, input);
+			*remainder = 0;
+			return;
+		}
+	
+		// Early exit for small input
+		if (input->size == 1)
+		{
+			bigint_reserve(quotient, 1);
+			quotient->limbs[0] = input->limbs[0] / divisor;
+			*remainder = input->limbs[0] % divisor;
+			quotient->size = (quotient->limbs[0] != 0) ? 1 : 0;
+			quotient->sign = input->sign;
+			return;
+		}
+	
+		int n = input->size;
+		bigint_reserve(quotient, n > 0 ? n : 1);
+		*remainder = limbs_divrem_1(quotient->limbs, input->limbs, n, divisor);
+		while (n > 1 && quotient->limbs[n - 1] == 0)
+			n--;
+		quotient->size = n > 0 ? n : 1;
+		quotient->sign = input->sign;
+	}
+	
+
+	// ---------- Division ----------
+	// Quotients or divisors shorter than DIV_NEWTON_THRESHOLD limbs use
+	// Knuth's algorithm D. Beyond that the quotient is estimated with a
+	// Newton-iterated reciprocal and fixed up with one back-multiplication.
+#define DIV_NEWTON_THRESHOLD tuning[TUNE_DIV_NEWTON]
+
+	// Knuth algorithm D. dp[0..dn) is normalized (top bit set), dn >= 2, and
+	// the top dn limbs of np[0..nn) are below it. Writes the nn-dn quotient
+	// limbs to qp and leaves the remainder in np[0..dn).
+	static void div_knuth(u64 *qp, u64 *np, int nn, const u64 *dp, int dn)
+	{
+		u64 d1 = dp[dn - 1], d0 = dp[dn - 2];
+		for (int j = nn - dn - 1; j >= 0; j--)
+		{
+			u64 n2 = np[j + dn], n1 = np[j + dn - 1], n0 = np[j + dn - 2];
+			__uint128_t num = ((__uint128_t)n2 << 64) | n1;
+			__uint128_t qhat = num / d1;
+			if (qhat > UINT64_MAX)
+				qhat = UINT64_MAX;
+			__uint128_t rhat = num - qhat * d1;
+			while (rhat <= UINT64_MAX && qhat * d0 > ((rhat << 64) | n0))
+			{
+				qhat--;
+				rhat += d1;
+			}
+			u64 borrow = limbs_submul_1(np + j, dp, dn, (u64)qhat);
+			if (np[j + dn] < borrow)
+			{
+				// qhat was one too large, add the divisor back
+				qhat--;
+				np[j + dn] += limbs_add_n(np + j, np + j, dp, dn);
+			}
+			np[j + dn] -= borrow;
+			qp[j] = (u64)qhat;
+		}
+	}
+
+	// xp[0..k] ~ floor(B^2k / dp[0..k)) for normalized dp, B = 2^64. The
+	// reciprocal of the top h = k/2+1 limbs is lifted with one Newton step
+	// x += x*(B^2k - d*x)/B^2k, which leaves it within a few units of the
+	// floor; callers settle that against an exact remainder.
+	static void div_reciprocal(u64 *xp, const u64 *dp, int k)
+	{
+		BigIntArenaMark mark = scratch_mark();
+		if (k < DIV_NEWTON_THRESHOLD)
+		{
+			u64 *np = scratch_alloc(2 * k + 1);
+			memset(np, 0, 2 * k * sizeof(u64));
+			np[2 * k] = 1;
+			div_knuth(xp, np, 2 * k + 1, dp, k);
+			scratch_release(mark);
+			return;
+		}
+
+		int h = k / 2 + 1, lo = k - h;
+		u64 *xh = scratch_alloc(h + 1);
+		div_reciprocal(xh, dp + lo, h);
+
+		// x0 = xh*B^lo, so B^2k - d*x0 = B^lo * e with e = B^(k+h) - d*xh
+		int en = k + h + 1;
+		u64 *p = scratch_alloc(en), *e = scratch_alloc(en);
+		limbs_mul(p, dp, k, xh, h + 1);
+		memset(e, 0, en * sizeof(u64));
+		e[en - 1] = 1;
+		int neg = limbs_abs_diff(e, e, en, p, en);
+		while (en > 1 && e[en - 1] == 0)
+			en--;
+
+		// x1 = x0 +- floor(xh*e / B^2h)
+		u64 *t = scratch_alloc(h + 1 + en);
+		limbs_mul(t, xh, h + 1, e, en);
+		memset(xp, 0, (k + 1) * sizeof(u64));
+		memcpy(xp + lo, xh, (h + 1) * sizeof(u64));
+		int tn = h + 1 + en - 2 * h;
+		if (tn > 0)
+		{
+			if (neg)
+				wrap_sub(xp, k + 1, t + 2 * h, tn < k + 1 ? tn : k + 1);
+			else
+				wrap_add(xp, k + 1, t + 2 * h, tn < k + 1 ? tn : k + 1);
+		}
+		scratch_release(mark);
+	}
+
+	// Quotient step against xp ~ B^2k / (top k limbs of d), k <= dn, qn <= k.
+	// Same contract as div_knuth. The Barrett-style estimate from the top
+	// qn+1 limbs of n is within a few units and is settled against the exact
+	// remainder.
+	static void div_approx(u64 *qp, u64 *np, int nn, const u64 *dp, int dn, const u64 *xp, int k)
+	{
+		int qn = nn - dn;
+		u64 one = 1;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *t = scratch_alloc(qn + k + 2);
+		limbs_mul(t, np + dn - 1, qn + 1, xp, k + 1);
+		if (t[qn + k + 1])
+			memset(qp, 0xff, qn * sizeof(u64)); // the true quotient is below B^qn
+		else
+			memcpy(qp, t + k + 1, qn * sizeof(u64));
+
+		// The remainder is within a few divisors of zero, so n - q*d is only
+		// needed mod B^(dn+1) and read as a signed value
+		int w = dn + 1;
+		u64 *r = scratch_alloc(w);
+		limbs_mullo(r, qp, qn, dp, dn, w);
+		limbs_sub_n(r, np, r, w);
+		while ((long long)r[w - 1] < 0)
+		{
+			wrap_sub(qp, qn, &one, 1);
+			wrap_add(r, w, dp, dn);
+		}
+		while (!limbs_is_zero(r + dn, w - dn) || limbs_cmp(r, dp, dn) >= 0)
+		{
+			wrap_add(qp, qn, &one, 1);
+			wrap_sub(r, w, dp, dn);
+		}
+		memcpy(np, r, dn * sizeof(u64));
+		memset(np + dn, 0, (nn - dn) * sizeof(u64));
+		scratch_release(mark);
+	}
+
+	// Same contract as div_knuth, given xp ~ B^2dn / dp from div_reciprocal.
+	// Long quotients are produced dn limbs at a time from the top, all
+	// against the one reciprocal.
+	static void div_preinv(u64 *qp, u64 *np, int nn, const u64 *dp, int dn, const u64 *xp)
+	{
+		int qn = nn - dn;
+		if (qn <= 0)
+			return;
+		int pos = qn - (qn % dn ? qn % dn : dn);
+		div_approx(qp + pos, np + pos, nn - pos, dp, dn, xp, dn);
+		while (pos > 0)
+		{
+			pos -= dn;
+			div_approx(qp + pos, np + pos, 2 * dn, dp, dn, xp, dn);
+		}
+	}
+
+	// Same contract as div_knuth, for large divisors and quotients
+	static void div_newton(u64 *qp, u64 *np, int nn, const u64 *dp, int dn)
+	{
+		int qn = nn - dn;
+		BigIntArenaMark mark = scratch_mark();
+		if (qn <= dn)
+		{
+			int k = qn + 1 < dn ? qn + 1 : dn;
+			u64 *xp = scratch_alloc(k + 1);
+			div_reciprocal(xp, dp + dn - k, k);
+			div_approx(qp, np, nn, dp, dn, xp, k);
+			scratch_release(mark);
+			return;
+		}
+
+		u64 *xp = scratch_alloc(dn + 1);
+		div_reciprocal(xp, dp, dn);
+		div_preinv(qp, np, nn, dp, dn, xp);
+		scratch_release(mark);
+	}
+
+	// Writes the limbs into dst, trimmed, zero as a single 0 limb
+	static void bigint_assign_limbs(BigInt *dst, const u64 *src, int n, int sign)
+	{
+		while (n > 0 && src[n - 1] == 0)
+			n--;
+		bigint_reserve(dst, n ? n : 1);
+		if (n > 0)
+			memmove(dst->limbs, src, n * sizeof(u64));
+		else
+		{
+			dst->limbs[0] = 0;
+			n = 1;
+			sign = 1;
+		}
+		dst->size = n;
+		dst->sign = sign;
+	}
+
+	// Truncated division: quotient = a / b rounded toward zero, remainder
+	// takes the sign of a. Either output may be NULL or alias an input.
+	void bigint_divide(const BigInt *a, const BigInt *b, BigInt *quotient, BigInt *remainder)
+	{
+		int an = a->size, bn = b->size;
+		while (an > 0 && a->limbs[an - 1] == 0)
+			an--;
+		while (bn > 0 && b->limbs[bn - 1] == 0)
+			bn--;
+		if (bn == 0)
+		{
+			fprintf(stderr, "Error: division by zero in bigint_divide\n");
+			exit(EXIT_FAILURE);
+		}
+		int qsign = ((a->sign < 0) != (b->sign < 0)) ? -1 : 1;
+		int rsign = (a->sign < 0) ? -1 : 1;
+
+		if (an < bn || (an == bn && limbs_cmp(a->limbs, b->limbs, an) < 0))
+		{
+			if (remainder)
+				bigint_assign_limbs(remainder, a->limbs, an, rsign);
+			if (quotient)
+				bigint_assign_limbs(quotient, NULL, 0, 1);
+			return;
+		}
+
+		int qn = an - bn + 1;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *q = scratch_alloc(qn), *n = scratch_alloc(an + 1);
+		if (bn == 1)
+		{
+			n[0] = limbs_divrem_1(q, a->limbs, an, b->limbs[0]);
+		}
+		else
+		{
+			int shift = __builtin_clzll(b->limbs[bn - 1]);
+			u64 *d = scratch_alloc(bn);
+			limbs_lshift(d, b->limbs, bn, shift);
+			n[an] = limbs_lshift(n, a->limbs, an, shift);
+			if (bn < DIV_NEWTON_THRESHOLD || qn < DIV_NEWTON_THRESHOLD)
+				div_knuth(q, n, an + 1, d, bn);
+			else
+				div_newton(q, n, an + 1, d, bn);
+			limbs_rshift(n, n, bn, shift);
+		}
+
+		if (quotient)
+			bigint_assign_limbs(quotient, q, qn, qsign);
+		if (remainder)
+			bigint_assign_limbs(remainder, n, bn, rsign);
+		scratch_release(mark);
+	}
+
+	// ---------- Barrett Reduction ----------
+	// For jobs that reduce many values by one modulus m. The context keeps m
+	// normalized (shifted left until its top bit is set) together with its
+	// reciprocal floor(B^2k / m) for k = size of m. Each reduction then costs
+	// two multiplications and a short correction, with no reciprocal work
+	// and no hardware division. Values longer than 2k limbs are reduced k
+	// limbs at a time from the top. Below BARRETT_THRESHOLD limbs Knuth's
+	// algorithm against the stored normalized modulus is still faster, and
+	// a one-limb modulus uses limbs_divrem_1.
+#define BARRETT_THRESHOLD 200
+
+	typedef struct
+	{
+		BigInt modulus; // m, positive
+		u64 *dp;		// m << shift, size limbs
+		u64 *xp;		// ~ B^2k / dp, size+1 limbs (NULL below the threshold)
+		int shift;
+		int size;
+	} BigIntBarrett;
+
+	void bigint_barrett_init(BigIntBarrett *ctx, const BigInt *modulus)
+	{
+		int n = modulus->size;
+		while (n > 0 && modulus->limbs[n - 1] == 0)
+			n--;
+		if (n == 0)
+		{
+			fprintf(stderr, "Error: zero modulus in bigint_barrett_init\n");
+			exit(EXIT_FAILURE);
+		}
+		bigint_init(&ctx->modulus, 0);
+		bigint_assign_limbs(&ctx->modulus, modulus->limbs, n, 1);
+		ctx->size = n;
+		ctx->shift = __builtin_clzll(modulus->limbs[n - 1]);
+		ctx->dp = NULL;
+		ctx->xp = NULL;
+		if (n == 1)
+			return;
+
+		ctx->dp = (u64 *)malloc(n * sizeof(u64));
+		if (n >= BARRETT_THRESHOLD)
+			ctx->xp = (u64 *)malloc((n + 1) * sizeof(u64));
+		if (!ctx->dp || (n >= BARRETT_THRESHOLD && !ctx->xp))
+		{
+			fprintf(stderr, "Memory allocation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		limbs_lshift(ctx->dp, modulus->limbs, n, ctx->shift);
+		if (ctx->xp)
+			div_reciprocal(ctx->xp, ctx->dp, n);
+	}
+
+	void bigint_barrett_free(BigIntBarrett *ctx)
+	{
+		bigint_free(&ctx->modulus);
+		free(ctx->dp);
+		free(ctx->xp);
+		ctx->dp = ctx->xp = NULL;
+		ctx->size = 0;
+	}
+
+	// result = a mod m, in [0, m). result may be a.
+	void bigint_barrett_reduce(const BigIntBarrett *ctx, const BigInt *a, BigInt *result)
+	{
+		int an = a->size, dn = ctx->size;
+		while (an > 0 && a->limbs[an - 1] == 0)
+			an--;
+		int negative = a->sign < 0 && an > 0;
+
+		BigIntArenaMark mark = scratch_mark();
+		u64 *np = scratch_alloc(an + 1 > dn ? an + 1 : dn);
+		int rn;
+		if (an < dn || (an == dn && limbs_cmp(a->limbs, ctx->modulus.limbs, an) < 0))
+		{
+			memcpy(np, a->limbs, an * sizeof(u64));
+			rn = an;
+		}
+		else if (dn == 1)
+		{
+			u64 *qp = scratch_alloc(an);
+			np[0] = limbs_divrem_1(qp, a->limbs, an, ctx->modulus.limbs[0]);
+			rn = 1;
+		}
+		else
+		{
+			u64 *qp = scratch_alloc(an + 1 - dn);
+			np[an] = limbs_lshift(np, a->limbs, an, ctx->shift);
+			if (ctx->xp)
+				div_preinv(qp, np, an + 1, ctx->dp, dn, ctx->xp);
+			else
+				div_knuth(qp, np, an + 1, ctx->dp, dn);
+			limbs_rshift(np, np, dn, ctx->shift);
+			rn = dn;
+		}
+		// A negative a leaves -r, which becomes m - r
+		if (negative && !limbs_is_zero(np, rn))
+		{
+			limbs_sub(np, ctx->modulus.limbs, dn, np, rn);
+			rn = dn;
+		}
+		bigint_assign_limbs(result, np, rn, 1);
+		scratch_release(mark);
+	}
+
+	// result = a * b mod m
+	void bigint_barrett_mulmod(const BigIntBarrett *ctx, const BigInt *a, const BigInt *b, BigInt *result)
+	{
+		bigint_multiply(a, b, result);
+		bigint_barrett_reduce(ctx, result, result);
+	}
+
+	// result = a + b mod m. Reduced operands take a single compare and
+	// subtract; anything else goes through a full reduction.
+	void bigint_barrett_addmod(const BigIntBarrett *ctx, const BigInt *a, const BigInt *b, BigInt *result)
+	{
+		const BigInt *m = &ctx->modulus;
+		int reduced = a->sign >= 0 && b->sign >= 0 && compare_abs(a, m) < 0 && compare_abs(b, m) < 0;
+		bigint_add(a, b, result);
+		if (!reduced)
+			bigint_barrett_reduce(ctx, result, result);
+		else if (compare_abs(result, m) >= 0)
+			bigint_subtract(result, m, result);
+	}
+
+	// ---------- Montgomery Arithmetic ----------
+	// For an odd modulus N of n limbs and R = B^n, values are kept as a*R mod
+	// N and multiplied with REDC, which divides by R through n addmul_1 passes
+	// instead of a division. R^2 mod N (for converting in) and -N^-1 mod B are
+	// computed once per context. Like BigInt itself, a context is not to be
+	// copied by plain struct assignment.
+	typedef struct
+	{
+		BigInt modulus; // N, odd and positive
+		u64 *r2;		// R^2 mod N, n limbs
+		u64 ninv;		// -N^-1 mod B
+		int size;		// n
+	} BigIntMont;
+
+	void bigint_mont_init(BigIntMont *ctx, const BigInt *modulus)
+	{
+		int n = modulus->size;
+		while (n > 0 && modulus->limbs[n - 1] == 0)
+			n--;
+		if (n == 0 || !(modulus->limbs[0] & 1))
+		{
+			fprintf(stderr, "Error: Montgomery modulus must be odd\n");
+			exit(EXIT_FAILURE);
+		}
+		bigint_init(&ctx->modulus, 0);
+		bigint_assign_limbs(&ctx->modulus, modulus->limbs, n, 1);
+		ctx->size = n;
+
+		u64 n0 = modulus->limbs[0], inv = n0; // correct to 3 bits, doubled per step
+		for (int i = 0; i < 5; i++)
+			inv *= 2 - n0 * inv;
+		ctx->ninv = 0 - inv;
+
+		BigInt t, r;
+		bigint_init(&t, 0);
+		bigint_init(&r, 0);
+		bigint_reserve(&t, 2 * n + 1);
+		memset(t.limbs, 0, 2 * n * sizeof(u64));
+		t.limbs[2 * n] = 1;
+		t.size = 2 * n + 1;
+		t.sign = 1;
+		bigint_divide(&t, &ctx->modulus, NULL, &r);
+		ctx->r2 = (u64 *)calloc(n, sizeof(u64));
+		if (!ctx->r2)
+		{
+			fprintf(stderr, "Memory allocation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		memcpy(ctx->r2, r.limbs, r.size * sizeof(u64));
+		bigint_free(&t);
+		bigint_free(&r);
+	}
+
+	void bigint_mont_free(BigIntMont *ctx)
+	{
+		bigint_free(&ctx->modulus);
+		free(ctx->r2);
+		ctx->r2 = NULL;
+		ctx->size = 0;
+	}
+
+	// rp[0..n) = tp[0..2n) / R mod N for tp < N*R; tp is clobbered and must
+	// not overlap rp. Runs in constant time: the final subtraction of N is
+	// always computed and selected with a mask.
+	static void mont_redc(u64 *rp, u64 *tp, const u64 *np, int n, u64 ninv)
+	{
+		u64 cy = 0;
+		for (int i = 0; i < n; i++)
+		{
+			u64 c = limbs_addmul_1(tp + i, np, n, tp[i] * ninv);
+			__uint128_t s = (__uint128_t)tp[i + n] + c + cy;
+			tp[i + n] = (u64)s;
+			cy = (u64)(s >> 64);
+		}
+		// t = tp[n..2n) + cy*R < 2N; keep t only when t - N borrows and cy == 0
+		u64 borrow = limbs_sub_n(rp, tp + n, np, n);
+		u64 keep = 0 - (borrow & (cy ^ 1));
+		for (int i = 0; i < n; i++)
+			rp[i] = (tp[n + i] & keep) | (rp[i] & ~keep);
+	}
+
+	// rp = ap * bp / R mod N, with tp as 2n limbs of scratch. rp may be ap or bp.
+	static void mont_mulmod(u64 *rp, const u64 *ap, const u64 *bp, const BigIntMont *ctx, u64 *tp)
+	{
+		limbs_mul(tp, ap, ctx->size, bp, ctx->size);
+		mont_redc(rp, tp, ctx->modulus.limbs, ctx->size, ctx->ninv);
+	}
+
+	// Same, on the schoolbook loop only, whose running time does not depend
+	// on the operand values (the faster tiers branch on intermediate signs)
+	static void mont_mulmod_ct(u64 *rp, const u64 *ap, const u64 *bp, const BigIntMont *ctx, u64 *tp)
+	{
+		mul_basecase(tp, ap, ctx->size, bp, ctx->size);
+		mont_redc(rp, tp, ctx->modulus.limbs, ctx->size, ctx->ninv);
+	}
+
+	// xp[0..n) = a*R mod N; a may be negative or not yet reduced
+	static void mont_to(u64 *xp, const BigInt *a, const BigIntMont *ctx, u64 *tp)
+	{
+		int n = ctx->size;
+		BigInt r;
+		bigint_init(&r, 0);
+		bigint_divide(a, &ctx->modulus, NULL, &r);
+		if (r.sign < 0 && !(r.size == 1 && r.limbs[0] == 0))
+			bigint_subtract(&ctx->modulus, &r, &r); // N - |r|
+		memset(xp, 0, n * sizeof(u64));
+		memcpy(xp, r.limbs, r.size * sizeof(u64));
+		bigint_free(&r);
+		mont_mulmod(xp, xp, ctx->r2, ctx, tp);
+	}
+
+	// result = xp / R mod N
+	static void mont_from(BigInt *result, const u64 *xp, const BigIntMont *ctx, u64 *tp)
+	{
+		int n = ctx->size;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *rp = scratch_alloc(n);
+		memcpy(tp, xp, n * sizeof(u64));
+		memset(tp + n, 0, n * sizeof(u64));
+		mont_redc(rp, tp, ctx->modulus.limbs, n, ctx->ninv);
+		bigint_assign_limbs(result, rp, n, 1);
+		scratch_release(mark);
+	}
+
+	// result = a * b mod N
+	void bigint_mont_mulmod(const BigIntMont *ctx, const BigInt *a, const BigInt *b, BigInt *result)
+	{
+		int n = ctx->size;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *tp = scratch_alloc(2 * n), *xp = scratch_alloc(n), *yp = scratch_alloc(n);
+		mont_to(xp, a, ctx, tp);
+		mont_to(yp, b, ctx, tp);
+		mont_mulmod(xp, xp, yp, ctx, tp);
+		mont_from(result, xp, ctx, tp);
+		scratch_release(mark);
+	}
+
+	// ---------- Modular Exponentiation ----------
+	// Left-to-right sliding window over the exponent bits: odd powers
+	// x, x^3, ..., x^(2^k-1) are tabulated, zero bits cost one squaring and
+	// each window of up to k bits ending in a one costs one multiplication.
+	// The constant-time variant uses a fixed 4-bit window over every limb of
+	// the exponent, reads the table by scanning all of it under a mask and
+	// stays on the schoolbook multiply, so neither branches nor memory
+	// accesses depend on the exponent or the intermediate values.
+#define POWM_CT_WINDOW 4
+
+	static int powm_window_bits(int bits)
+	{
+		static const int limits[] = {7, 25, 81, 241, 673};
+		int k = 1;
+		while (k <= 5 && bits > limits[k - 1])
+			k++;
+		return k;
+	}
+
+	static int exponent_bit(const u64 *ep, int i)
+	{
+		return (int)(ep[i / 64] >> (i % 64)) & 1;
+	}
+
+	static int powm_check_exponent(const BigInt *exponent)
+	{
+		int en = exponent->size;
+		while (en > 0 && exponent->limbs[en - 1] == 0)
+			en--;
+		if (en > 0 && exponent->sign < 0)
+		{
+			fprintf(stderr, "Error: negative exponent in modular exponentiation\n");
+			exit(EXIT_FAILURE);
+		}
+		return en;
+	}
+
+	void bigint_mont_powm(const BigIntMont *ctx, const BigInt *base, const BigInt *exponent, BigInt *result)
+	{
+		int n = ctx->size, en = powm_check_exponent(exponent);
+		const u64 *ep = exponent->limbs;
+		int bits = en ? 64 * en - __builtin_clzll(ep[en - 1]) : 0;
+		int k = powm_window_bits(bits);
+
+		BigIntArenaMark mark = scratch_mark();
+		u64 *tp = scratch_alloc(2 * n), *rp = scratch_alloc(n);
+		u64 *table = scratch_alloc((size_t)n << (k - 1)), *x2 = scratch_alloc(n);
+		mont_to(table, base, ctx, tp);
+		if (k > 1)
+		{
+			mont_mulmod(x2, table, table, ctx, tp);
+			for (int i = 1; i < 1 << (k - 1); i++)
+				mont_mulmod(table + i * n, table + (i - 1) * n, x2, ctx, tp);
+		}
+
+		int started = 0;
+		for (int i = bits - 1; i >= 0;)
+		{
+			if (!exponent_bit(ep, i))
+			{
+				mont_mulmod(rp, rp, rp, ctx, tp);
+				i--;
+				continue;
+			}
+			int j = i - k + 1 > 0 ? i - k + 1 : 0;
+			while (!exponent_bit(ep, j))
+				j++;
+			int w = 0;
+			for (int b = i; b >= j; b--)
+				w = 2 * w + exponent_bit(ep, b);
+			if (started)
+			{
+				for (int b = i; b >= j; b--)
+					mont_mulmod(rp, rp, rp, ctx, tp);
+				mont_mulmod(rp, rp, table + (w >> 1) * n, ctx, tp);
+			}
+			else
+				memcpy(rp, table + (w >> 1) * n, n * sizeof(u64));
+			started = 1;
+			i = j - 1;
+		}
+		if (!started)
+		{
+			// x^0 = 1, which is R mod N in Montgomery form
+			memset(x2, 0, n * sizeof(u64));
+			x2[0] = 1;
+			mont_mulmod(rp, ctx->r2, x2, ctx, tp);
+		}
+		mont_from(result, rp, ctx, tp);
+		scratch_release(mark);
+	}
+
+	void bigint_mont_powm_ct(const BigIntMont *ctx, const BigInt *base, const BigInt *exponent, BigInt *result)
+	{
+		int n = ctx->size, en = powm_check_exponent(exponent);
+		const u64 *ep = exponent->limbs;
+		const int k = POWM_CT_WINDOW, entries = 1 << POWM_CT_WINDOW;
+
+		BigIntArenaMark mark = scratch_mark();
+		u64 *tp = scratch_alloc(2 * n), *rp = scratch_alloc(n), *sel = scratch_alloc(n);
+		u64 *table = scratch_alloc((size_t)n * entries);
+
+		// table[i] = x^i in Montgomery form, table[0] = R mod N
+		memset(sel, 0, n * sizeof(u64));
+		sel[0] = 1;
+		mont_mulmod_ct(table, ctx->r2, sel, ctx, tp);
+		mont_to(table + n, base, ctx, tp);
+		for (int i = 2; i < entries; i++)
+			mont_mulmod_ct(table + i * n, table + (i - 1) * n, table + n, ctx, tp);
+
+		memcpy(rp, table, n * sizeof(u64));
+		for (int i = 64 * en - k; i >= 0; i -= k)
+		{
+			for (int s = 0; s < k; s++)
+				mont_mulmod_ct(rp, rp, rp, ctx, tp);
+			u64 w = (ep[i / 64] >> (i % 64)) & (entries - 1); // 64 % k == 0
+			memset(sel, 0, n * sizeof(u64));
+			for (int t = 0; t < entries; t++)
+			{
+				u64 d = (u64)t ^ w;
+				u64 mask = ((d | (0 - d)) >> 63) - 1; // all ones when t == w
+				for (int j = 0; j < n; j++)
+					sel[j] |= table[t * n + j] & mask;
+			}
+			mont_mulmod_ct(rp, rp, sel, ctx, tp);
+		}
+		mont_from(result, rp, ctx, tp);
+		scratch_release(mark);
+	}
+
+	// rp[0..w) = xp^e mod 2^k, the top limb masked with `top`. Products keep
+	// only their low w limbs. The constant-time form multiplies at every
+	// exponent bit and keeps the product under a mask, on the schoolbook
+	// loop only.
+	static void powm_2k(u64 *rp, const u64 *xp, int w, u64 top, const BigInt *exponent, int ct)
+	{
+		int en = powm_check_exponent(exponent);
+		const u64 *ep = exponent->limbs;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *tp = scratch_alloc(2 * w), *sp = scratch_alloc(w);
+		memset(rp, 0, w * sizeof(u64));
+		rp[0] = 1;
+		int i = 64 * en - 1;
+		if (!ct)
+			while (i >= 0 && !exponent_bit(ep, i))
+				i--;
+		for (; i >= 0; i--)
+		{
+			if (ct)
+			{
+				mul_basecase(tp, rp, w, rp, w);
+				memcpy(sp, tp, w * sizeof(u64));
+				mul_basecase(tp, sp, w, xp, w);
+				u64 mask = 0 - (u64)exponent_bit(ep, i);
+				for (int j = 0; j < w; j++)
+					rp[j] = (tp[j] & mask) | (sp[j] & ~mask);
+			}
+			else
+			{
+				limbs_mullo(sp, rp, w, rp, w, w);
+				if (exponent_bit(ep, i))
+					limbs_mullo(rp, sp, w, xp, w, w);
+				else
+					memcpy(rp, sp, w * sizeof(u64));
+			}
+			rp[w - 1] &= top;
+		}
+		scratch_release(mark);
+	}
+
+	// ip[0..w) = qp^-1 mod B^w for odd qp, by Newton's iteration
+	// y = y * (2 - q*y), which doubles the correct low bits each step
+	static void inverse_2k(u64 *ip, const u64 *qp, int qn, int w)
+	{
+		BigIntArenaMark mark = scratch_mark();
+		u64 *qw = scratch_alloc(w), *tp = scratch_alloc(w), *yp = scratch_alloc(w);
+		memset(qw, 0, w * sizeof(u64));
+		memcpy(qw, qp, (qn < w ? qn : w) * sizeof(u64));
+		u64 inv = qp[0];
+		for (int i = 0; i < 5; i++)
+			inv *= 2 - qp[0] * inv;
+		memset(ip, 0, w * sizeof(u64));
+		ip[0] = inv;
+		for (int bits = 64; bits < 64 * w; bits *= 2)
+		{
+			limbs_mullo(tp, qw, w, ip, w, w);
+			for (int j = 0; j < w; j++) // 2 - q*y
+				tp[j] = ~tp[j];
+			limbs_add_1(tp, tp, w, 3);
+			limbs_mullo(yp, ip, w, tp, w, w);
+			memcpy(ip, yp, w * sizeof(u64));
+		}
+		scratch_release(mark);
+	}
+
+	static void modexp_dispatch(const BigInt *base, const BigInt *exponent, const BigInt *modulus, BigInt *result, int ct)
+	{
+		int mn = modulus->size;
+		while (mn > 0 && modulus->limbs[mn - 1] == 0)
+			mn--;
+		if (mn == 0)
+		{
+			fprintf(stderr, "Error: zero modulus in modular exponentiation\n");
+			exit(EXIT_FAILURE);
+		}
+		if (mn == 1 && modulus->limbs[0] == 1)
+		{
+			bigint_assign_limbs(result, NULL, 0, 1);
+			return;
+		}
+		if (modulus->limbs[0] & 1)
+		{
+			BigIntMont ctx;
+			bigint_mont_init(&ctx, modulus);
+			if (ct)
+				bigint_mont_powm_ct(&ctx, base, exponent, result);
+			else
+				bigint_mont_powm(&ctx, base, exponent, result);
+			bigint_mont_free(&ctx);
+			return;
+		}
+
+		// Montgomery needs an odd modulus: split an even one as q * 2^k with q
+		// odd, power modulo each part and join the two with the CRT
+		int k = (int)bigint_trailing_zeros(modulus), w = (k + 63) / 64;
+		u64 top = k % 64 ? (1ULL << (k % 64)) - 1 : ~0ULL;
+		BigInt q, r1;
+		bigint_init(&q, 0);
+		bigint_init(&r1, 0);
+		bigint_assign_limbs(&q, modulus->limbs, mn, 1);
+		bigint_shift_right(&q, k);
+		int qn = q.size;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *xp = scratch_alloc(w), *r2 = scratch_alloc(w), *rp = scratch_alloc(qn + w);
+
+		// base mod 2^k, from the two's complement of a negative base
+		int bn = base->size < w ? base->size : w;
+		memset(xp, 0, w * sizeof(u64));
+		memcpy(xp, base->limbs, bn * sizeof(u64));
+		if (base->sign < 0)
+		{
+			for (int i = 0; i < w; i++)
+				xp[i] = ~xp[i];
+			limbs_add_1(xp, xp, w, 1);
+		}
+		xp[w - 1] &= top;
+		powm_2k(r2, xp, w, top, exponent, ct);
+		if (qn == 1 && q.limbs[0] == 1)
+		{
+			bigint_assign_limbs(result, r2, w, 1);
+			bigint_free(&q);
+			bigint_free(&r1);
+			scratch_release(mark);
+			return;
+		}
+
+		BigIntMont ctx;
+		bigint_mont_init(&ctx, &q);
+		if (ct)
+			bigint_mont_powm_ct(&ctx, base, exponent, &r1);
+		else
+			bigint_mont_powm(&ctx, base, exponent, &r1);
+		bigint_mont_free(&ctx);
+
+		// result = r1 + q * ((r2 - r1) * q^-1 mod 2^k), on fixed-size limbs
+		// so that the join does not branch on the values either
+		u64 *r1p = scratch_alloc(qn > w ? qn : w), *ip = scratch_alloc(w), *hp = scratch_alloc(w);
+		memset(r1p, 0, (qn > w ? qn : w) * sizeof(u64));
+		memcpy(r1p, r1.limbs, (r1.size < qn ? r1.size : qn) * sizeof(u64));
+		inverse_2k(ip, q.limbs, qn, w);
+		limbs_sub_n(r2, r2, r1p, w);
+		r2[w - 1] &= top;
+		limbs_mullo(hp, r2, w, ip, w, w);
+		hp[w - 1] &= top;
+		mul_basecase(rp, q.limbs, qn, hp, w);
+		limbs_add(rp, rp, qn + w, r1p, qn);
+		bigint_assign_limbs(result, rp, qn + w, 1);
+		bigint_free(&q);
+		bigint_free(&r1);
+		scratch_release(mark);
+	}
+
+	// result = base^exponent mod |modulus|, in [0, |modulus|)
+	void bigint_modexp(const BigInt *base, const BigInt *exponent, const BigInt *modulus, BigInt *result)
+	{
+		modexp_dispatch(base, exponent, modulus, result, 0);
+	}
+
+	// Same, with running time independent of the exponent bits; an even
+	// modulus goes through the CRT split above, whose steps depend only on
+	// the modulus. The exponent's limb count is still visible.
+	void bigint_modexp_ct(const BigInt *base, const BigInt *exponent, const BigInt *modulus, BigInt *result)
+	{
+		modexp_dispatch(base, exponent, modulus, result, 1);
+	}
+
+	// ---------- GCD ----------
+	// Euclid's algorithm in three tiers. Plain division steps handle operands
+	// of very different sizes. Lehmer steps run Knuth's algorithm L on the
+	// leading 126 bits of both numbers, collecting every quotient that is
+	// certain for the full numbers into a matrix with one-limb entries, and
+	// apply it in a single pass over the limbs (about 64 bits of progress per
+	// pass). From GCD_HGCD_THRESHOLD limbs the half-GCD takes over: the
+	// matrix that halves the leading part of the numbers is found recursively
+	// and applied with full multiplications, for O(M(n) log n) overall.
+	//
+	// Every step, each matrix the half-GCD returns included, is unimodular,
+	// so the gcd and the cofactor relation s a + t b = g are exact whatever
+	// quotients it picks. Stopping one limb short of the exact bound makes
+	// those the quotients of the full numbers nearly always; when a matrix
+	// overshoots, the pair is put back in order (a >= b >= 0) and reduction
+	// goes on from there, which only costs time. bigint_gcdext bounds its
+	// cofactors itself rather than rely on the quotients.
+#define HGCD_THRESHOLD 120
+#define GCD_HGCD_THRESHOLD 400
+
+	static int bigint_is_zero(const BigInt *x)
+	{
+		return x->size == 0 || (x->size == 1 && x->limbs[0] == 0);
+	}
+
+	// Binary GCD on single limbs
+	static u64 gcd_u64(u64 a, u64 b)
+	{
+		if (a == 0 || b == 0)
+			return a | b;
+		int shift = __builtin_ctzll(a | b);
+		a >>= __builtin_ctzll(a);
+		while (b)
+		{
+			b >>= __builtin_ctzll(b);
+			if (a > b)
+			{
+				u64 t = a;
+				a = b;
+				b = t;
+			}
+			b -= a;
+		}
+		return a << shift;
+	}
+
+	// The remainder pair (a, b) and the rows of a matrix riding along with
+	// it: t[0..cols) follow a and t[2..2+cols) follow b. Everything is held
+	// through pointers so steps can rotate storage instead of copying.
+	struct GcdState
+	{
+		BigInt *a, *b;
+		BigInt *t[4];
+		BigInt *spare[2];
+		int cols;
+		BigInt q, r;
+		BigInt store[8];
+	};
+
+	static void gcd_state_init(GcdState *st, int cols)
+	{
+		for (int i = 0; i < 8; i++)
+			bigint_init(&st->store[i], 0);
+		bigint_init(&st->q, 0);
+		bigint_init(&st->r, 0);
+		st->a = &st->store[0];
+		st->b = &st->store[1];
+		for (int i = 0; i < 4; i++)
+			st->t[i] = &st->store[2 + i];
+		st->spare[0] = &st->store[6];
+		st->spare[1] = &st->store[7];
+		st->cols = cols;
+		// Identity
+		bigint_assign_limbs(st->t[0], NULL, 0, 1);
+		bigint_assign_limbs(st->t[1], NULL, 0, 1);
+		bigint_assign_limbs(st->t[2], NULL, 0, 1);
+		bigint_assign_limbs(st->t[3], NULL, 0, 1);
+		st->t[0]->limbs[0] = 1;
+		st->t[3]->limbs[0] = 1;
+	}
+
+	static void gcd_state_free(GcdState *st)
+	{
+		for (int i = 0; i < 8; i++)
+			bigint_free(&st->store[i]);
+		bigint_free(&st->q);
+		bigint_free(&st->r);
+	}
+
+	static void gcd_swap(BigInt **x, BigInt **y)
+	{
+		BigInt *t = *x;
+		*x = *y;
+		*y = t;
+	}
+
+	// One Euclid step with a full division: (a, b) <- (b, a mod b)
+	static void gcd_div_step(GcdState *st)
+	{
+		bigint_divide(st->a, st->b, &st->q, st->a);
+		gcd_swap(&st->a, &st->b);
+		for (int c = 0; c < st->cols; c++)
+		{
+			BigInt *x = st->t[c], *y = st->t[2 + c], *p = st->spare[0];
+			bigint_multiply(&st->q, y, p);
+			p->sign = -p->sign;
+			bigint_add(x, p, x);
+			gcd_swap(&st->t[c], &st->t[2 + c]);
+		}
+	}
+
+	// Leading 126 bits of the n-limb window of xp[0..xn), shifted as a number
+	// whose top limb has `shift` leading zeros
+	static unsigned __int128 gcd_top_bits(const u64 *xp, int xn, int n, int shift)
+	{
+		u64 w[3];
+		for (int i = 0; i < 3; i++)
+		{
+			int j = n - 1 - i;
+			w[i] = (j >= 0 && j < xn) ? xp[j] : 0;
+		}
+		u64 hi = w[0], lo = w[1];
+		if (shift)
+		{
+			hi = (hi << shift) | (w[1] >> (64 - shift));
+			lo = (lo << shift) | (w[2] >> (64 - shift));
+		}
+		return (((unsigned __int128)hi << 64) | lo) >> 2;
+	}
+
+	static __int128 gcd_quotient(__int128 num, __int128 den)
+	{
+		if (num < den)
+			return 0;
+		num -= den;
+		if (num < den)
+			return 1;
+		num -= den;
+		if (num < den)
+			return 2;
+		return 2 + num / den;
+	}
+
+	// Knuth's algorithm L: runs Euclid on the leading bits u, v of a >= b
+	// while the quotients of (u + A)/(v + C) and (u + B)/(v + D) agree, which
+	// makes them the quotients of the full numbers. Stores |A|, |B|, |C|, |D|
+	// in m, where a' = A a + B b and b' = C a + D b are the remainders after
+	// the k steps taken; A and D have sign (-1)^k, B and C the opposite one.
+	static int lehmer_matrix(const BigInt *a, const BigInt *b, u64 m[4])
+	{
+		int n = a->size, shift = __builtin_clzll(a->limbs[n - 1]);
+		__int128 u = (__int128)gcd_top_bits(a->limbs, a->size, n, shift);
+		__int128 v = (__int128)gcd_top_bits(b->limbs, b->size, n, shift);
+		const __int128 limit = (__int128)1 << 62;
+		__int128 A = 1, B = 0, C = 0, D = 1;
+		int k = 0;
+		while (v + C > 0 && v + D > 0)
+		{
+			__int128 q = gcd_quotient(u + A, v + C);
+			if (q >= limit || q != gcd_quotient(u + B, v + D))
+				break;
+			__int128 nc = A - q * C, nd = B - q * D;
+			if (nc >= limit || nc <= -limit || nd >= limit || nd <= -limit)
+				break;
+			A = C;
+			C = nc;
+			B = D;
+			D = nd;
+			// Exact even if q * v runs past 127 bits on the way
+			__int128 nv = (__int128)((unsigned __int128)u - (unsigned __int128)q * (unsigned __int128)v);
+			u = v;
+			v = nv;
+			k++;
+		}
+		m[0] = (u64)(A < 0 ? -A : A);
+		m[1] = (u64)(B < 0 ? -B : B);
+		m[2] = (u64)(C < 0 ? -C : C);
+		m[3] = (u64)(D < 0 ? -D : D);
+		return k;
+	}
+
+	// r = p x + q y for signed one-limb p and q
+	static void gcd_lincomb_1(BigInt *r, const BigInt *x, long long p, const BigInt *y, long long q, BigInt *t)
+	{
+		bigint_multiply_u64(x, (u64)(p < 0 ? -p : p), r);
+		if (p < 0)
+			r->sign = -r->sign;
+		bigint_multiply_u64(y, (u64)(q < 0 ? -q : q), t);
+		if (q < 0)
+			t->sign = -t->sign;
+		bigint_add(r, t, r);
+	}
+
+	// One Lehmer step on a >= b with a of two limbs or more. Returns 0 when
+	// no quotient could be certified (a division step is due instead).
+	static int gcd_lehmer_step(GcdState *st)
+	{
+		u64 m[4];
+		int k = lehmer_matrix(st->a, st->b, m);
+		if (k == 0)
+			return 0;
+
+		BigInt *a = st->a, *b = st->b;
+		int n = a->size;
+		bigint_reserve(b, n);
+		for (int i = b->size; i < n; i++)
+			b->limbs[i] = 0;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *x = scratch_alloc(2 * n), *y = x + n;
+		// Both remainders are non-negative and below a, so the products'
+		// high limbs cancel out
+		if (k & 1)
+		{
+			limbs_mul_1(x, b->limbs, n, m[1]);
+			limbs_submul_1(x, a->limbs, n, m[0]);
+			limbs_mul_1(y, a->limbs, n, m[2]);
+			limbs_submul_1(y, b->limbs, n, m[3]);
+		}
+		else
+		{
+			limbs_mul_1(x, a->limbs, n, m[0]);
+			limbs_submul_1(x, b->limbs, n, m[1]);
+			limbs_mul_1(y, b->limbs, n, m[3]);
+			limbs_submul_1(y, a->limbs, n, m[2]);
+		}
+		bigint_assign_limbs(a, x, n, 1);
+		bigint_assign_limbs(b, y, n, 1);
+		scratch_release(mark);
+
+		long long s = (k & 1) ? -1 : 1;
+		long long A = s * (long long)m[0], B = -s * (long long)m[1];
+		long long C = -s * (long long)m[2], D = s * (long long)m[3];
+		for (int c = 0; c < st->cols; c++)
+		{
+			BigInt *nx = st->spare[0], *ny = st->spare[1];
+			gcd_lincomb_1(nx, st->t[c], A, st->t[2 + c], B, &st->q);
+			gcd_lincomb_1(ny, st->t[c], C, st->t[2 + c], D, &st->q);
+			st->spare[0] = st->t[c];
+			st->spare[1] = st->t[2 + c];
+			st->t[c] = nx;
+			st->t[2 + c] = ny;
+		}
+		return 1;
+	}
+
+	static void gcd_step(GcdState *st)
+	{
+		if (st->a->size < 2 || !gcd_lehmer_step(st))
+			gcd_div_step(st);
+	}
+
+	// r = p x + q y, into storage that aliases none of the operands
+	static void gcd_lincomb(BigInt *r, const BigInt *p, const BigInt *x, const BigInt *q, const BigInt *y, BigInt *t)
+	{
+		bigint_multiply(p, x, r);
+		bigint_multiply(q, y, t);
+		bigint_add(r, t, r);
+	}
+
+	// Applies the matrix S = sub->t, found by the half-GCD on the limbs of
+	// (a, b) from k up, to the state: (a, b) <- S (a, b) and the rows
+	// likewise, then restores a >= b >= 0. sub->a and sub->b already hold S
+	// times the high parts, so only the low k limbs of a and b get multiplied.
+	static void gcd_apply_matrix(GcdState *st, const GcdState *sub, int k)
+	{
+		BigInt *const *s = sub->t;
+		BigInt lo_a, lo_b;
+		bigint_init(&lo_a, 0);
+		bigint_init(&lo_b, 0);
+		bigint_assign_limbs(&lo_a, st->a->limbs, k < st->a->size ? k : st->a->size, 1);
+		bigint_assign_limbs(&lo_b, st->b->limbs, k < st->b->size ? k : st->b->size, 1);
+		for (int i = 0; i < 2; i++)
+		{
+			BigInt *r = st->spare[i];
+			const BigInt *hi = i ? sub->b : sub->a;
+			gcd_lincomb(r, s[2 * i], &lo_a, s[2 * i + 1], &lo_b, &st->q);
+			// + hi B^k
+			bigint_reserve(&st->q, hi->size + k);
+			memset(st->q.limbs, 0, k * sizeof(u64));
+			memcpy(st->q.limbs + k, hi->limbs, hi->size * sizeof(u64));
+			st->q.size = hi->size + k;
+			st->q.sign = 1;
+			if (!bigint_is_zero(hi))
+				bigint_add(r, &st->q, r);
+		}
+		gcd_swap(&st->a, &st->spare[0]);
+		gcd_swap(&st->b, &st->spare[1]);
+		bigint_free(&lo_a);
+		bigint_free(&lo_b);
+
+		for (int c = 0; c < st->cols; c++)
+		{
+			BigInt *nx = st->spare[0], *ny = st->spare[1];
+			gcd_lincomb(nx, s[0], st->t[c], s[1], st->t[2 + c], &st->q);
+			gcd_lincomb(ny, s[2], st->t[c], s[3], st->t[2 + c], &st->q);
+			st->spare[0] = st->t[c];
+			st->spare[1] = st->t[2 + c];
+			st->t[c] = nx;
+			st->t[2 + c] = ny;
+		}
+
+		if (st->a->sign < 0 && !bigint_is_zero(st->a))
+		{
+			st->a->sign = 1;
+			for (int c = 0; c < st->cols; c++)
+				st->t[c]->sign = -st->t[c]->sign;
+		}
+		if (st->b->sign < 0 && !bigint_is_zero(st->b))
+		{
+			st->b->sign = 1;
+			for (int c = 0; c < st->cols; c++)
+				st->t[2 + c]->sign = -st->t[2 + c]->sign;
+		}
+		st->a->sign = st->b->sign = 1;
+		if (compare_abs(st->a, st->b) < 0)
+		{
+			gcd_swap(&st->a, &st->b);
+			for (int c = 0; c < st->cols; c++)
+				gcd_swap(&st->t[c], &st->t[2 + c]);
+		}
+	}
+
+	static int hgcd(GcdState *st);
+
+	// Runs the half-GCD on the limbs of (a, b) from limb k up and applies the
+	// matrix it finds to the whole numbers. Returns 0 if it found none.
+	static int hgcd_high(GcdState *st, int k)
+	{
+		GcdState sub;
+		gcd_state_init(&sub, 2);
+		bigint_assign_limbs(sub.a, st->a->limbs + k, st->a->size - k, 1);
+		bigint_assign_limbs(sub.b, st->b->limbs + k, st->b->size > k ? st->b->size - k : 0, 1);
+		int reduced = hgcd(&sub);
+		if (reduced)
+			gcd_apply_matrix(st, &sub, k);
+		gcd_state_free(&sub);
+		return reduced;
+	}
+
+	// Half-GCD: reduces a >= b of n limbs until b fits in n/2 + 1 limbs,
+	// collecting the steps in the rows (which start as the identity).
+	// Returns 0 if b already fits.
+	static int hgcd(GcdState *st)
+	{
+		int n = st->a->size, s = n / 2 + 1;
+		if (st->b->size <= s)
+			return 0;
+
+		if (n >= HGCD_THRESHOLD)
+		{
+			// The top half brings both numbers to about 3n/4 limbs, then
+			// the top of what is left brings them to s
+			hgcd_high(st, n / 2);
+			while (st->a->size > 3 * n / 4 + 1 && st->b->size > s + 1)
+				gcd_step(st);
+			if (st->b->size > s + 1)
+				hgcd_high(st, 2 * s - st->a->size + 1);
+		}
+		// Lehmer steps can overshoot by a limb; division steps finish exactly
+		while (st->b->size > s + 1)
+			gcd_step(st);
+		while (st->b->size > s)
+			gcd_div_step(st);
+		return 1;
+	}
+
+	// Reduces the pair until b is zero, or until a fits in one limb when
+	// `word` is set; the caller finishes that with gcd_u64
+	static void gcd_run(GcdState *st, int word)
+	{
+		while (!bigint_is_zero(st->b))
+		{
+			int n = st->a->size;
+			if (n == 1 && word)
+				return;
+			// Half-GCD on the top two thirds takes a third off both numbers
+			if (n >= GCD_HGCD_THRESHOLD && st->b->size > n - n / 3 && hgcd_high(st, n / 3))
+				continue;
+			gcd_step(st);
+		}
+	}
+
+	// Loads (|x|, |y|) ordered, with the cofactor rows set so that each of a
+	// and b is its row times (|x|, |y|)
+	static void gcd_load(GcdState *st, const BigInt *x, const BigInt *y)
+	{
+		bigint_assign_limbs(st->a, x->limbs, x->size, 1);
+		bigint_assign_limbs(st->b, y->limbs, y->size, 1);
+		if (compare_abs(st->a, st->b) < 0)
+		{
+			gcd_swap(&st->a, &st->b);
+			gcd_swap(&st->t[0], &st->t[2]);
+			gcd_swap(&st->t[1], &st->t[3]);
+		}
+	}
+
+	// result = gcd(a, b) >= 0, with gcd(0, 0) = 0
+	void bigint_gcd(const BigInt *a, const BigInt *b, BigInt *result)
+	{
+		GcdState st;
+		gcd_state_init(&st, 0);
+		gcd_load(&st, a, b);
+		gcd_run(&st, 1);
+		if (!bigint_is_zero(st.b))
+			st.a->limbs[0] = gcd_u64(st.a->limbs[0], st.b->limbs[0]);
+		bigint_copy(result, st.a);
+		gcd_state_free(&st);
+	}
+
+	// g = gcd(a, b) = s a + t b, with |s| < |b| / g when b != 0 (s = 0 when
+	// g = |b|); s and t may be NULL, and any output may alias an input.
+	// gcd(0, 0) gives g = s = t = 0.
+	void bigint_gcdext(const BigInt *a, const BigInt *b, BigInt *g, BigInt *s, BigInt *t)
+	{
+		GcdState st;
+		gcd_state_init(&st, 1);
+		gcd_load(&st, a, b);
+		gcd_run(&st, 0);
+
+		// st.a = s' |a| + t' |b|; t' comes from one exact division
+		BigInt *sp = st.t[0], *tp = st.t[1];
+		if (bigint_is_zero(st.a))
+		{
+			bigint_assign_limbs(sp, NULL, 0, 1);
+			bigint_assign_limbs(tp, NULL, 0, 1);
+		}
+		else if (bigint_is_zero(b))
+		{
+			bigint_assign_limbs(tp, NULL, 0, 1);
+		}
+		else
+		{
+			// s' mod |b|/g, then t' from one exact division
+			bigint_assign_limbs(&st.r, b->limbs, b->size, 1);
+			bigint_divide(&st.r, st.a, &st.q, NULL);
+			bigint_divide(sp, &st.q, NULL, sp);
+			bigint_assign_limbs(&st.r, a->limbs, a->size, 1);
+			bigint_multiply(sp, &st.r, &st.q);
+			st.q.sign = -st.q.sign;
+			bigint_add(st.a, &st.q, &st.q);
+			bigint_assign_limbs(&st.r, b->limbs, b->size, 1);
+			bigint_divide(&st.q, &st.r, tp, NULL);
+		}
+		if (a->sign < 0)
+			sp->sign = -sp->sign;
+		if (b->sign < 0)
+			tp->sign = -tp->sign;
+		if (bigint_is_zero(sp))
+			sp->sign = 1;
+		if (bigint_is_zero(tp))
+			tp->sign = 1;
+
+		if (s)
+			bigint_copy(s, sp);
+		if (t)
+			bigint_copy(t, tp);
+		bigint_copy(g, st.a);
+		gcd_state_free(&st);
+	}
+
+	// result = a^-1 mod |m| in [0, |m|). Returns 0, leaving result alone,
+	// when the inverse does not exist.
+	int bigint_invert(const BigInt *a, const BigInt *m, BigInt *result)
+	{
+		if (bigint_is_zero(m))
+			return 0;
+		BigInt g, s, mm;
+		bigint_init(&g, 0);
+		bigint_init(&s, 0);
+		bigint_init(&mm, 0);
+		bigint_assign_limbs(&mm, m->limbs, m->size, 1);
+		bigint_gcdext(a, &mm, &g, &s, NULL);
+		int ok = g.size == 1 && g.limbs[0] == 1;
+		if (ok)
+		{
+			bigint_divide(&s, &mm, NULL, &s);
+			if (s.sign < 0 && !bigint_is_zero(&s))
+				bigint_add(&s, &mm, &s);
+			s.sign = 1;
+			bigint_copy(result, &s);
+		}
+		bigint_free(&g);
+		bigint_free(&s);
+		bigint_free(&mm);
+		return ok;
+	}
+
+	// ---------- Roots ----------
+	// Integer k-th roots by Newton's iteration x <- ((k-1) x + n / x^(k-1)) / k.
+	// Each level starts from the root of the top half of n's bits, shifted
+	// back into place, so the precision doubles per level and the whole
+	// root costs a few full-size divisions. Started above the root, the
+	// integer iteration decreases monotonically onto floor(n^(1/k)).
+
+	static u64 isqrt_u128(unsigned __int128 n)
+	{
+		long double e = sqrtl((long double)n);
+		u64 r = e >= 18446744073709551615.0L ? ~0ULL : (u64)e;
+		// One Newton step in case long double is only a double
+		if (r)
+		{
+			unsigned __int128 t = ((unsigned __int128)r + n / r) / 2;
+			r = t > ~0ULL ? ~0ULL : (u64)t;
+		}
+		while (r && (unsigned __int128)r * r > n)
+			r--;
+		while (r != ~0ULL && (unsigned __int128)(r + 1) * (r + 1) <= n)
+			r++;
+		return r;
+	}
+
+	// Whether r^k <= n, without overflowing
+	static int root_pow_le(u64 r, unsigned long k, u64 n)
+	{
+		unsigned __int128 p = 1;
+		for (unsigned long i = 0; i < k; i++)
+		{
+			p *= r;
+			if (p > n)
+				return 0;
+		}
+		return 1;
+	}
+
+	static u64 root_u64(u64 n, unsigned long k)
+	{
+		if (n < 2 || k >= 64)
+			return n ? 1 : 0;
+		u64 r = (u64)pow((double)n, 1.0 / k);
+		while (r && !root_pow_le(r, k, n))
+			r--;
+		while (root_pow_le(r + 1, k, n))
+			r++;
+		return r;
+	}
+
+	static void bigint_set_u64(BigInt *x, u64 v)
+	{
+		bigint_assign_limbs(x, NULL, 0, 1);
+		x->limbs[0] = v;
+	}
+
+	// r = x^e, e >= 1
+	static void root_pow(const BigInt *x, unsigned long e, BigInt *r)
+	{
+		int top = 63 - __builtin_clzll(e);
+		bigint_copy(r, x);
+		for (int i = top - 1; i >= 0; i--)
+		{
+			bigint_square(r, r);
+			if ((e >> i) & 1)
+				bigint_multiply(r, x, r);
+		}
+	}
+
+	// Upper estimate of floor(sqrt(n)), at most one above. The next level
+	// up keeps two spare bits (m = b/4 - 2), which holds the error there
+	// to (e+1)^2/22 + 1 and so keeps it at one all the way up.
+	static void sqrt_approx(const BigInt *n, BigInt *s)
+	{
+		int b = bigint_bit_length(n);
+		if (b <= 128)
+		{
+			unsigned __int128 v = b > 64 ? ((unsigned __int128)n->limbs[1] << 64) | n->limbs[0] : (b ? n->limbs[0] : 0);
+			bigint_set_u64(s, isqrt_u128(v));
+			return;
+		}
+		int m = b / 4 - 2;
+		BigInt t;
+		bigint_init(&t, 0);
+		bigint_copy(&t, n);
+		bigint_shift_right(&t, 2 * m);
+		sqrt_approx(&t, s);
+		bigint_add_u64(s, 1, s);
+		bigint_shift_left(s, m);
+		// s = (s + n / s) / 2
+		bigint_divide(n, s, &t, NULL);
+		bigint_add(s, &t, s);
+		bigint_shift_right(s, 1);
+		bigint_free(&t);
+	}
+
+	// x = floor(n^(1/k)) for n >= 0 and 3 <= k < bit length of n
+	static void root_newton(const BigInt *n, unsigned long k, BigInt *x)
+	{
+		int b = bigint_bit_length(n);
+		if (b <= 64)
+		{
+			bigint_set_u64(x, root_u64(b ? n->limbs[0] : 0, k));
+			return;
+		}
+		BigInt p, y;
+		bigint_init(&p, 0);
+		bigint_init(&y, 0);
+		int m = (int)(b / k / 2);
+		if (m)
+		{
+			bigint_copy(&p, n);
+			bigint_shift_right(&p, (int)(k * m));
+			root_newton(&p, k, x);
+			bigint_add_u64(x, 1, x);
+			bigint_shift_left(x, m);
+		}
+		else
+		{
+			// The root has at most two bits
+			bigint_set_u64(x, 1ULL << ((b + k - 1) / k));
+		}
+
+		for (;;)
+		{
+			u64 rem;
+			root_pow(x, k - 1, &p);
+			bigint_divide(n, &p, &y, NULL);
+			bigint_multiply_u64(x, k - 1, &p);
+			bigint_add(&p, &y, &y);
+			bigint_divide_u64(&y, k, &y, &rem);
+			if (y.size == 0)
+				bigint_set_u64(&y, 0);
+			if (compare_abs(&y, x) >= 0)
+				break;
+			bigint_copy(x, &y);
+		}
+		bigint_free(&p);
+		bigint_free(&y);
+	}
+
+	// root = floor(|a|^(1/k)) with the sign of a, rem = a - root^k. k must be
+	// at least 1 and odd when a is negative. rem may be NULL; either output
+	// may alias a.
+	void bigint_rootrem(const BigInt *a, unsigned long k, BigInt *root, BigInt *rem)
+	{
+		int negative = a->sign < 0 && bigint_bit_length(a) > 0;
+		if (k == 0 || (negative && !(k & 1)))
+		{
+			fprintf(stderr, "Error: %s in bigint_rootrem\n", k ? "even root of a negative number" : "zeroth root");
+			exit(EXIT_FAILURE);
+		}
+
+		BigInt n, x, r;
+		bigint_init(&n, 0);
+		bigint_init(&x, 0);
+		bigint_init(&r, 0);
+		bigint_assign_limbs(&n, a->limbs, a->size, 1);
+		int b = bigint_bit_length(&n);
+		if (k == 1)
+			bigint_copy(&x, &n);
+		else if (b == 0 || (unsigned long)b <= k)
+			bigint_set_u64(&x, b ? 1 : 0);
+		else if (k == 2)
+			sqrt_approx(&n, &x);
+		else
+			root_newton(&n, k, &x);
+
+		// r = n - x^k; only the square root can come out one too high
+		if (k == 1)
+			bigint_set_u64(&r, 0);
+		else
+		{
+			root_pow(&x, k, &r);
+			bigint_subtract(&n, &r, &r);
+			bigint_set_u64(&n, 1);
+			while (r.sign < 0 && !bigint_is_zero(&r))
+			{
+				// (x-1)^2 = x^2 - x - (x-1)
+				bigint_add(&r, &x, &r);
+				bigint_subtract(&x, &n, &x);
+				bigint_add(&r, &x, &r);
+			}
+		}
+		if (negative)
+		{
+			x.sign = bigint_is_zero(&x) ? 1 : -1;
+			r.sign = bigint_is_zero(&r) ? 1 : -1;
+		}
+
+		bigint_copy(root, &x);
+		if (rem)
+			bigint_copy(rem, &r);
+		bigint_free(&n);
+		bigint_free(&x);
+		bigint_free(&r);
+	}
+
+	// root = floor(|a|^(1/k)) with the sign of a; returns 1 when the root is
+	// exact
+	int bigint_root(const BigInt *a, unsigned long k, BigInt *root)
+	{
+		BigInt r;
+		bigint_init(&r, 0);
+		bigint_rootrem(a, k, root, &r);
+		int exact = bigint_is_zero(&r);
+		bigint_free(&r);
+		return exact;
+	}
+
+	// root = floor(sqrt(a)), rem = a - root^2 (zero exactly for perfect
+	// squares). a must be non-negative; rem may be NULL.
+	void bigint_sqrtrem(const BigInt *a, BigInt *root, BigInt *rem)
+	{
+		if (a->sign < 0 && bigint_bit_length(a) > 0)
+		{
+			fprintf(stderr, "Error: square root of a negative number in bigint_sqrtrem\n");
+			exit(EXIT_FAILURE);
+		}
+		bigint_rootrem(a, 2, root, rem);
+	}
+
+	void bigint_sqrt(const BigInt *a, BigInt *root)
+	{
+		bigint_sqrtrem(a, root, NULL);
+	}
+
+	// ---------- Factorial, Catalan and Fibonacci ----------
+	// n! by Luschny's prime swing: n! = (n/2)!^2 * swing(n), and the swing
+	// number n! / (n/2)!^2 is the product of the primes p <= n, each raised
+	// to the number of odd digits among floor(n/p^i). The Catalan numbers
+	// come from the same primes, raised to the Legendre exponents of
+	// (2n)! / (n! (n+1)!). The prime powers are packed into limbs and
+	// multiplied by balanced binary splitting, so the big products are of
+	// similar-sized operands and land in the fast tiers. Powers of two are
+	// kept out and shifted in at the end.
+#define PRODUCT_BASECASE 16
+
+	// Odd primes up to n, in a malloc'd array
+	static u64 *odd_primes(u64 n, int *count)
+	{
+		u64 half = n / 2 + 1;
+		unsigned char *composite = (unsigned char *)calloc(half, 1);
+		u64 *primes = (u64 *)malloc((half + 1) * sizeof(u64));
+		if (!composite || !primes)
+		{
+			fprintf(stderr, "Error: memory allocation failed in odd_primes\n");
+			exit(EXIT_FAILURE);
+		}
+		int k = 0;
+		// Entry i stands for 2i + 1
+		for (u64 i = 1; 2 * i + 1 <= n; i++)
+		{
+			if (composite[i])
+				continue;
+			u64 p = 2 * i + 1;
+			primes[k++] = p;
+			for (u64 j = p * p / 2; j < half; j += p)
+				composite[j] = 1;
+		}
+		free(composite);
+		*count = k;
+		return primes;
+	}
+
+	// Factors packed into as few limbs as will hold them
+	struct FactorList
+	{
+		u64 *v;
+		int n;
+		int capacity;
+		u64 cur;
+	};
+
+	static void factors_init(FactorList *f, int capacity)
+	{
+		f->v = (u64 *)malloc((capacity > 0 ? capacity : 1) * sizeof(u64));
+		if (!f->v)
+		{
+			fprintf(stderr, "Error: memory allocation failed in factors_init\n");
+			exit(EXIT_FAILURE);
+		}
+		f->n = 0;
+		f->capacity = capacity > 0 ? capacity : 1;
+		f->cur = 1;
+	}
+
+	static void factors_flush(FactorList *f)
+	{
+		if (f->n == f->capacity)
+		{
+			f->capacity *= 2;
+			f->v = (u64 *)realloc(f->v, f->capacity * sizeof(u64));
+			if (!f->v)
+			{
+				fprintf(stderr, "Error: memory allocation failed in factors_flush\n");
+				exit(EXIT_FAILURE);
+			}
+		}
+		f->v[f->n++] = f->cur;
+		f->cur = 1;
+	}
+
+	static void factors_push(FactorList *f, u64 p)
+	{
+		if (f->cur > ~0ULL / p)
+			factors_flush(f);
+		f->cur *= p;
+	}
+
+	// r = v[0] * ... * v[n-1]
+	static void product_limbs(const u64 *v, int n, BigInt *r)
+	{
+		if (n <= PRODUCT_BASECASE)
+		{
+			bigint_reserve(r, n + 1);
+			r->limbs[0] = 1;
+			int size = 1;
+			for (int i = 0; i < n; i++)
+			{
+				u64 carry = limbs_mul_1(r->limbs, r->limbs, size, v[i]);
+				if (carry)
+					r->limbs[size++] = carry;
+			}
+			r->size = size;
+			r->sign = 1;
+			return;
+		}
+		BigInt t;
+		bigint_init(&t, 0);
+		product_limbs(v, n / 2, r);
+		product_limbs(v + n / 2, n - n / 2, &t);
+		bigint_multiply(r, &t, r);
+		bigint_free(&t);
+	}
+
+	// Multiplies everything pushed so far into r and releases the list
+	static void factors_product(FactorList *f, BigInt *r)
+	{
+		if (f->cur > 1)
+			factors_flush(f);
+		product_limbs(f->v, f->n, r);
+		free(f->v);
+	}
+
+	// Odd part of n! from the odd primes up to n
+	static void odd_factorial(u64 n, const u64 *primes, int np, BigInt *r)
+	{
+		if (n < 3)
+		{
+			bigint_assign_limbs(r, NULL, 0, 1);
+			r->limbs[0] = 1;
+			return;
+		}
+		odd_factorial(n / 2, primes, np, r);
+		bigint_square(r, r);
+
+		// Odd part of the swing number
+		FactorList f;
+		factors_init(&f, 64);
+		for (int i = 0; i < np && primes[i] <= n; i++)
+			for (u64 q = n / primes[i]; q; q /= primes[i])
+				if (q & 1)
+					factors_push(&f, primes[i]);
+		BigInt s;
+		bigint_init(&s, 0);
+		factors_product(&f, &s);
+		bigint_multiply(r, &s, r);
+		bigint_free(&s);
+	}
+
+	// result = n!
+	void bigint_factorial(unsigned long n, BigInt *result)
+	{
+		int np;
+		u64 *primes = odd_primes(n, &np);
+		odd_factorial(n, primes, np, result);
+		free(primes);
+		bigint_shift_left(result, (int)(n - __builtin_popcountll(n)));
+	}
+
+	// Exponent of p in m! (Legendre)
+	static u64 legendre(u64 m, u64 p)
+	{
+		u64 e = 0;
+		for (m /= p; m; m /= p)
+			e += m;
+		return e;
+	}
+
+	// result = (2n)! / (n! (n+1)!), the n-th Catalan number
+	void bigint_catalan(unsigned long n, BigInt *result)
+	{
+		int np;
+		u64 *primes = odd_primes(2 * (u64)n, &np);
+		FactorList f;
+		factors_init(&f, np / 4 + 1);
+		for (int i = 0; i < np; i++)
+		{
+			u64 p = primes[i];
+			u64 e = legendre(2 * (u64)n, p) - legendre(n, p) - legendre(n + 1, p);
+			while (e--)
+				factors_push(&f, p);
+		}
+		free(primes);
+		factors_product(&f, result);
+		bigint_shift_left(result, (int)(legendre(2 * (u64)n, 2) - legendre(n, 2) - legendre(n + 1, 2)));
+	}
+
+	// result = F(n) by fast doubling with two squarings per bit:
+	// F(2k-1) = F(k)^2 + F(k-1)^2, F(2k+1) = 4F(k)^2 - F(k-1)^2 + 2(-1)^k,
+	// F(2k) = F(2k+1) - F(2k-1)
+	void bigint_fibonacci(unsigned long n, BigInt *result)
+	{
+		if (n == 0)
+		{
+			bigint_assign_limbs(result, NULL, 0, 1);
+			return;
+		}
+		BigInt f, g, a, b, two;
+		bigint_init(&f, 1); // F(k)
+		bigint_init(&g, 0); // F(k-1)
+		bigint_init(&a, 0);
+		bigint_init(&b, 0);
+		bigint_init(&two, 2);
+		int odd = 1; // k = 1
+		for (int i = 62 - __builtin_clzll(n); i >= 0; i--)
+		{
+			bigint_square(&f, &a);
+			bigint_square(&g, &b);
+			bigint_add(&a, &b, &g); // F(2k-1)
+			bigint_shift_left(&a, 2);
+			bigint_subtract(&a, &b, &f);
+			if (odd)
+				bigint_subtract(&f, &two, &f);
+			else
+				bigint_add(&f, &two, &f); // F(2k+1)
+			if ((n >> i) & 1)
+			{
+				bigint_subtract(&f, &g, &g); // F(2k)
+				odd = 1;
+			}
+			else
+			{
+				bigint_subtract(&f, &g, &f); // F(2k)
+				odd = 0;
+			}
+		}
+		bigint_copy(result, &f);
+		bigint_free(&f);
+		bigint_free(&g);
+		bigint_free(&a);
+		bigint_free(&b);
+		bigint_free(&two);
+	}
+
+	// ---------- Powers of Ten ----------
+	// 10^(19*2^k), squared up on first use and kept for the process lifetime.
+	// Levels are built under a lock and published through count, so threads
+	// that find their level ready never wait.
+	static const BigInt *ten_power(int k)
+	{
+		static BigInt powers[48];
+		static std::atomic<int> count(0);
+		static std::mutex lock;
+		if (count.load(std::memory_order_acquire) > k)
+			return &powers[k];
+		std::lock_guard<std::mutex> guard(lock);
+		int n = count.load(std::memory_order_relaxed);
+		if (n == 0)
+		{
+			bigint_init(&powers[0], 0);
+			powers[0].limbs[0] = CHUNK_BASE;
+			powers[0].size = 1;
+			powers[0].sign = 1;
+			n = 1;
+		}
+		for (; n <= k; n++)
+		{
+			bigint_init(&powers[n], 0);
+			bigint_multiply(&powers[n - 1], &powers[n - 1], &powers[n]);
+		}
+		count.store(n, std::memory_order_release);
+		return &powers[k];
+	}
+
+	// ---------- From String ----------
+	// Digits are read in 19-digit chunks with Horner's rule. From
+	// FROMSTR_DC_THRESHOLD limbs' worth of digits up, the string is split so
+	// that its low part has 19*2^k digits, both parts are parsed recursively
+	// and joined as high * 10^(19*2^k) + low with the cached power.
+#define FROMSTR_DC_THRESHOLD 40
+
+	static void from_digits_basecase(BigInt *num, const char *str, size_t len)
+	{
+		bigint_reserve(num, (int)(len / CHUNK_DIGITS) + 2);
+		int n = 0;
+		size_t i = 0, first = len % CHUNK_DIGITS ? len % CHUNK_DIGITS : CHUNK_DIGITS;
+		for (size_t end = first; i < len; end += CHUNK_DIGITS)
+		{
+			u64 carry = 0;
+			for (; i < end; i++)
+				carry = carry * 10 + (u64)(str[i] - '0');
+			carry = limbs_mul_1c(num->limbs, num->limbs, n, CHUNK_BASE, carry);
+			if (carry)
+				num->limbs[n++] = carry;
+		}
+		num->size = n;
+		num->sign = 1;
+	}
+
+	static void from_digits(BigInt *num, const char *str, size_t len)
+	{
+		if (len <= (size_t)FROMSTR_DC_THRESHOLD * CHUNK_DIGITS)
+		{
+			from_digits_basecase(num, str, len);
+			return;
+		}
+		int k = 0;
+		while (((size_t)CHUNK_DIGITS << (k + 1)) < len)
+			k++;
+		size_t low = (size_t)CHUNK_DIGITS << k;
+		BigInt hi, lo;
+		bigint_init(&hi, 0);
+		bigint_init(&lo, 0);
+		from_digits(&hi, str, len - low);
+		from_digits(&lo, str + len - low, low);
+		bigint_multiply(&hi, ten_power(k), num);
+		bigint_add(num, &lo, num);
+		bigint_free(&hi);
+		bigint_free(&lo);
+	}
+
+	void bigint_from_string(BigInt *num, const char *str)
+	{
+		while (*str == ' ')
+			str++;
+
+		int sign = 1;
+		if (*str == '-')
+		{
+			sign = -1;
+			++str;
+		}
+		while (*str == ' ')
+			str++;
+
+		bigint_init(num, 0);
+		from_digits(num, str, strlen(str));
+		num->sign = sign;
+	}
+	// ---------- To String ----------
+	// Digits are produced in 19-digit chunks, 10^19 being the largest power of
+	// ten in a limb. From TOSTR_DC_THRESHOLD limbs up the number is split by a
+	// cached power 10^(19*2^k) near its square root, and both halves are
+	// converted recursively with the low half zero-padded to 19*2^k digits.
+#define TOSTR_DC_THRESHOLD 40
+
+	// Writes the digits of xp[0..xn) so that they end just before `end` and
+	// returns the first one. With width > 0 the output is zero-padded to
+	// exactly width digits, otherwise it has no leading zeros.
+	static char *digits_basecase(char *end, const u64 *xp, int xn, size_t width)
+	{
+		while (xn > 0 && xp[xn - 1] == 0)
+			xn--;
+		BigIntArenaMark mark = scratch_mark();
+		u64 *t = scratch_alloc(xn);
+		memcpy(t, xp, xn * sizeof(u64));
+		char *p = end;
+		while (xn > 0)
+		{
+			u64 chunk = limbs_divrem_1(t, t, xn, CHUNK_BASE);
+			while (xn > 0 && t[xn - 1] == 0)
+				xn--;
+			for (int d = 0; d < CHUNK_DIGITS && (xn > 0 || chunk); d++)
+			{
+				*--p = '0' + chunk % 10;
+				chunk /= 10;
+			}
+		}
+		while ((size_t)(end - p) < width)
+			*--p = '0';
+		scratch_release(mark);
+		return p;
+	}
+
+	static char *digits_dc(char *end, const BigInt *x, size_t width)
+	{
+		if (x->size < TOSTR_DC_THRESHOLD)
+			return digits_basecase(end, x->limbs, x->size, width);
+
+		int k = 0;
+		while (ten_power(k + 1)->size <= (x->size + 1) / 2)
+			k++;
+		BigInt q, r;
+		bigint_init(&q, 0);
+		bigint_init(&r, 0);
+		bigint_divide(x, ten_power(k), &q, &r);
+		size_t low = (size_t)CHUNK_DIGITS << k;
+		digits_dc(end, &r, low);
+		char *p = digits_dc(end - low, &q, width > low ? width - low : 0);
+		bigint_free(&q);
+		bigint_free(&r);
+		return p;
+	}
+
+	char *to_string(const BigInt *num)
+	{
+		if (num->size == 0 || (num->size == 1 && num->limbs[0] == 0))
+			return strdup("0");
+
+		// 64*log10(2) < 19.3 digits per limb, plus sign and terminator
+		size_t max_digits = (size_t)num->size * 20 + 2;
+		char *buffer = (char *)malloc(max_digits);
+		if (!buffer)
+		{
+			fprintf(stderr, "Failed to allocate buffer for BigInt string\n");
+			exit(EXIT_FAILURE);
+		}
+
+		char *end = buffer + max_digits - 1;
+		*end = '\0';
+		char *p = digits_dc(end, num, 0);
+		if (num->sign < 0)
+			*--p = '-';
+		memmove(buffer, p, end - p + 1);
+
+		return buffer; // Caller must free()
+	}
+
+	void bigint_print(const BigInt *num)
+	{
+		char *str = to_string(num);
+		printf("%s", str);
+		free(str);
+	}
+
+	// ---------- Power-of-Two Bases ----------
+	// In bases 2, 8 and 16 every digit is a fixed group of bits, so parsing
+	// and printing are single linear passes over the limbs with no division.
+	// Hex digits are read in either case and written in lower case. Base 10
+	// is passed on to the decimal routines.
+
+	static int base_bits(int base, const char *who)
+	{
+		if (base == 2 || base == 8 || base == 16)
+			return base == 2 ? 1 : base == 8 ? 3 : 4;
+		fprintf(stderr, "Error: unsupported base %d in %s\n", base, who);
+		exit(EXIT_FAILURE);
+	}
+
+	// Digit values by character, -1 for anything that is not a hex digit;
+	// a table keeps the parse loop free of unpredictable branches
+	static const signed char *digit_values(void)
+	{
+		static signed char table[256];
+		static int ready = [] {
+			memset(table, -1, sizeof(table));
+			for (int c = 0; c < 10; c++)
+				table['0' + c] = (signed char)c;
+			for (int c = 0; c < 6; c++)
+				table['a' + c] = table['A' + c] = (signed char)(10 + c);
+			return 1;
+		}();
+		(void)ready;
+		return table;
+	}
+
+	// Parses an optionally signed number in the given base. Returns 0, with
+	// num set to zero, when a character is not a digit of the base.
+	int bigint_from_string_base(BigInt *num, const char *str, int base)
+	{
+		if (base == 10)
+		{
+			// bigint_from_string takes the digits on trust, so check them here
+			const char *p = str;
+			while (*p == ' ')
+				p++;
+			if (*p == '-')
+				p++;
+			while (*p == ' ')
+				p++;
+			for (; *p; p++)
+				if (*p < '0' || *p > '9')
+				{
+					bigint_init(num, 0);
+					return 0;
+				}
+			bigint_from_string(num, str);
+			return 1;
+		}
+		int bits = base_bits(base, "bigint_from_string_base");
+		while (*str == ' ')
+			str++;
+		int sign = 1;
+		if (*str == '-')
+		{
+			sign = -1;
+			++str;
+		}
+		while (*str == ' ')
+			str++;
+
+		size_t len = strlen(str);
+		int n = (int)((len * bits + 63) / 64);
+		bigint_init(num, 0);
+		bigint_reserve(num, n ? n : 1);
+		// Digits from the least significant end; an octal digit may straddle
+		// two limbs, its high bits starting the next one
+		const signed char *values = digit_values();
+		u64 acc = 0;
+		int shift = 0, size = 0;
+		for (size_t i = len; i-- > 0;)
+		{
+			int d = values[(unsigned char)str[i]];
+			if (d < 0 || d >= base)
+			{
+				bigint_assign_limbs(num, NULL, 0, 1);
+				return 0;
+			}
+			acc |= (u64)d << shift;
+			shift += bits;
+			if (shift >= 64)
+			{
+				num->limbs[size++] = acc;
+				shift -= 64;
+				acc = shift ? (u64)d >> (bits - shift) : 0;
+			}
+		}
+		if (shift)
+			num->limbs[size++] = acc;
+		bigint_assign_limbs(num, num->limbs, size, sign);
+		return 1;
+	}
+
+	// Returns a malloc'd string of num in the given base
+	char *bigint_to_string_base(const BigInt *num, int base)
+	{
+		if (base == 10)
+			return to_string(num);
+		int bits = base_bits(base, "bigint_to_string_base");
+		size_t nbits = bigint_bit_length(num);
+		size_t digits = nbits ? (nbits + bits - 1) / bits : 1;
+		char *buffer = (char *)malloc(digits + 2);
+		if (!buffer)
+		{
+			fprintf(stderr, "Failed to allocate buffer for BigInt string\n");
+			exit(EXIT_FAILURE);
+		}
+
+		char *p = buffer;
+		if (num->sign < 0 && nbits)
+			*p++ = '-';
+		for (size_t i = digits; i-- > 0;)
+		{
+			size_t pos = i * bits, limb = pos / 64;
+			int off = pos % 64;
+			u64 d = nbits ? num->limbs[limb] >> off : 0;
+			if (off + bits > 64 && limb + 1 < (size_t)num->size)
+				d |= num->limbs[limb + 1] << (64 - off);
+			*p++ = "0123456789abcdef"[d & (base - 1)];
+		}
+		*p = '\0';
+		return buffer; // Caller must free()
+	}
+
+	// ---------- Import and Export ----------
+	// Raw word arrays in the manner of mpz_import/mpz_export: `count` words
+	// of `size` bytes each, the most significant word first for order 1 and
+	// last for order -1, with the bytes in a word big-endian for endian 1,
+	// little-endian for -1 and in host order for 0. Only the magnitude moves.
+	// Least-significant-first little-endian 8-byte words are the limb layout
+	// itself and are copied whole; other layouts take one pass over the bytes.
+
+	static int limb_layout(int order, size_t size, int endian)
+	{
+		return order < 0 && size == sizeof(u64) && endian < 0 && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+	}
+
+	static int host_endian(int endian)
+	{
+		if (endian)
+			return endian;
+		return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? -1 : 1;
+	}
+
+	// num = the non-negative value of the words at data; num must be
+	// initialized
+	void bigint_import(BigInt *num, size_t count, int order, size_t size, int endian, const void *data)
+	{
+		endian = host_endian(endian);
+		size_t bytes = count * size;
+		int n = (int)((bytes + 7) / 8);
+		bigint_reserve(num, n ? n : 1);
+		if (bytes && limb_layout(order, size, endian))
+			memcpy(num->limbs, data, bytes);
+		else
+		{
+			const unsigned char *src = (const unsigned char *)data;
+			memset(num->limbs, 0, n * sizeof(u64));
+			for (size_t w = 0; w < count; w++) // w-th least significant word
+			{
+				const unsigned char *word = src + (order < 0 ? w : count - 1 - w) * size;
+				for (size_t j = 0; j < size; j++)
+				{
+					size_t k = w * size + j;
+					num->limbs[k / 8] |= (u64)word[endian < 0 ? j : size - 1 - j] << (8 * (k % 8));
+				}
+			}
+		}
+		bigint_assign_limbs(num, num->limbs, n, 1);
+	}
+
+	// Writes |num| as words to data, or to a malloc'd buffer when data is
+	// NULL, and returns it. *countp (if given) receives the number of words
+	// written, 0 for zero.
+	void *bigint_export(void *data, size_t *countp, int order, size_t size, int endian, const BigInt *num)
+	{
+		if (size == 0)
+		{
+			fprintf(stderr, "Error: zero word size in bigint_export\n");
+			exit(EXIT_FAILURE);
+		}
+		endian = host_endian(endian);
+		size_t bytes = (bigint_bit_length(num) + 7) / 8;
+		size_t count = (bytes + size - 1) / size;
+		if (countp)
+			*countp = count;
+		if (count == 0)
+			return data;
+		if (!data && !(data = malloc(count * size)))
+		{
+			fprintf(stderr, "Memory allocation failed\n");
+			exit(EXIT_FAILURE);
+		}
+
+		unsigned char *dst = (unsigned char *)data;
+		if (limb_layout(order, size, endian))
+			memcpy(dst, num->limbs, count * size);
+		else
+			for (size_t w = 0; w < count; w++)
+			{
+				unsigned char *word = dst + (order < 0 ? w : count - 1 - w) * size;
+				for (size_t j = 0; j < size; j++)
+				{
+					size_t k = w * size + j;
+					word[endian < 0 ? j : size - 1 - j] = k < bytes ? (unsigned char)(num->limbs[k / 8] >> (8 * (k % 8))) : 0;
+				}
+			}
+		return data;
+	}
+
+	// ---------- Out-of-Core Multiplication ----------
+	// Products of operands too large for memory. The operands and the
+	// product are files of raw limbs in host byte order, mapped into memory.
+	// The operands are cut into blocks of `block` limbs, and the product is
+	// produced one output block at a time. Output block k sums every
+	// a_i * b_j with i + j = k into an in-memory accumulator, with each
+	// block product going through the usual in-memory tiers (NTT at these
+	// sizes). Its low limbs are then final and are written out once. The
+	// working set is two operand blocks, the product and accumulator, and
+	// the NTT scratch: about 16 * block limbs. Blocks are dropped from the
+	// process after use, so the resident set stays near that bound while
+	// the page cache does the I/O.
+#if BIGINT_HAVE_MMAP
+// Default working-set budget in bytes, and the smallest block in limbs
+#define DISK_DEFAULT_MEMORY (1ULL << 30)
+#define DISK_MIN_BLOCK 512
+
+	typedef struct
+	{
+		size_t block;		// limbs per operand block
+		size_t peak_rss;	// bytes, the process's resident high-water mark
+		u64 bytes_read;		// operand bytes streamed through the working set
+		u64 bytes_written;	// product bytes written back
+		u64 disk_read;		// bytes fetched from storage (Linux /proc/self/io, else 0)
+		u64 disk_written;	// bytes sent to storage (likewise)
+	} BigIntDiskStats;
+
+	typedef struct
+	{
+		u64 *limbs;
+		size_t size;
+		int fd;
+	} BigIntMap;
+
+	// Writes |num| to path as raw limbs; 0 on success, -1 with errno set
+	int bigint_file_save(const char *path, const BigInt *num)
+	{
+		FILE *f = fopen(path, "wb");
+		if (!f)
+			return -1;
+		size_t n = num->size;
+		int ok = fwrite(num->limbs, sizeof(u64), n, f) == n;
+		return fclose(f) == 0 && ok ? 0 : -1;
+	}
+
+	// Reads a file of raw limbs into num; 0 on success, -1 with errno set.
+	// A BigInt holds at most INT_MAX limbs, so larger files fail with EFBIG.
+	int bigint_file_load(const char *path, BigInt *num)
+	{
+		FILE *f = fopen(path, "rb");
+		if (!f)
+			return -1;
+		struct stat st;
+		if (fstat(fileno(f), &st) < 0)
+		{
+			fclose(f);
+			return -1;
+		}
+		if ((u64)st.st_size / sizeof(u64) > INT_MAX)
+		{
+			fclose(f);
+			errno = EFBIG;
+			return -1;
+		}
+		int n = (int)(st.st_size / sizeof(u64));
+		bigint_reserve(num, n ? n : 1);
+		int ok = (int)fread(num->limbs, sizeof(u64), n, f) == n;
+		fclose(f);
+		if (!ok)
+			return -1;
+		bigint_assign_limbs(num, num->limbs, n, 1);
+		return 0;
+	}
+
+	// Maps path read-only, or creates it with `create` limbs of zeros
+	static int disk_map(BigIntMap *map, const char *path, size_t create, int writable)
+	{
+		map->limbs = NULL;
+		map->fd = writable ? open(path, O_RDWR | O_CREAT | O_TRUNC, 0644) : open(path, O_RDONLY);
+		if (map->fd < 0)
+			return -1;
+		if (writable)
+		{
+			map->size = create;
+			if (ftruncate(map->fd, (off_t)(create * sizeof(u64))) < 0)
+				return -1;
+		}
+		else
+		{
+			off_t bytes = lseek(map->fd, 0, SEEK_END);
+			if (bytes < 0)
+				return -1;
+			map->size = bytes / sizeof(u64);
+		}
+		if (map->size == 0)
+			return 0;
+		void *p = mmap(NULL, map->size * sizeof(u64), writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, map->fd, 0);
+		if (p == MAP_FAILED)
+			return -1;
+		map->limbs = (u64 *)p;
+		return 0;
+	}
+
+	static void disk_unmap(BigIntMap *map)
+	{
+		if (map->limbs)
+			munmap(map->limbs, map->size * sizeof(u64));
+		if (map->fd >= 0)
+			close(map->fd);
+		map->limbs = NULL;
+		map->fd = -1;
+	}
+
+	// Whether path names the open file fd
+	static int disk_same_file(const char *path, int fd)
+	{
+		struct stat ps, fs;
+		return stat(path, &ps) == 0 && fstat(fd, &fs) == 0 && ps.st_dev == fs.st_dev && ps.st_ino == fs.st_ino;
+	}
+
+	// Releases the process's pages of a mapped range; the page cache keeps
+	// them (dirty ones included) until the kernel writes them back
+	static void disk_drop(const u64 *p, size_t n)
+	{
+		uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+		uintptr_t lo = (uintptr_t)p & ~(page - 1), hi = (uintptr_t)(p + n);
+		madvise((void *)lo, hi - lo, MADV_DONTNEED);
+	}
+
+	static size_t disk_peak_rss(void)
+	{
+		size_t kb = 0;
+		FILE *f = fopen("/proc/self/status", "r");
+		if (f)
+		{
+			char line[256];
+			while (fgets(line, sizeof(line), f))
+				if (sscanf(line, "VmHWM: %zu kB", &kb) == 1)
+					break;
+			fclose(f);
+		}
+		if (!kb)
+		{
+			struct rusage ru;
+			getrusage(RUSAGE_SELF, &ru);
+			kb = ru.ru_maxrss;
+		}
+		return kb * 1024;
+	}
+
+	static void disk_io(u64 *read, u64 *written)
+	{
+		*read = *written = 0;
+		FILE *f = fopen("/proc/self/io", "r");
+		if (!f)
+			return;
+		char line[256];
+		unsigned long long v;
+		while (fgets(line, sizeof(line), f))
+			if (sscanf(line, "read_bytes: %llu", &v) == 1)
+				*read = v;
+			else if (sscanf(line, "write_bytes: %llu", &v) == 1)
+				*written = v;
+		fclose(f);
+	}
+
+	// The largest power-of-two block whose working set fits in memory bytes,
+	// no larger than the operands need
+	static size_t disk_block(size_t memory, size_t an, size_t bn)
+	{
+		size_t limit = (memory ? memory : DISK_DEFAULT_MEMORY) / (16 * sizeof(u64));
+		size_t need = an > bn ? an : bn, block = DISK_MIN_BLOCK;
+		while (2 * block <= limit && block < need && 2 * block <= INT_MAX / 4)
+			block *= 2;
+		return block;
+	}
+
+	// Writes a * b to result_path for the limb files a_path and b_path,
+	// keeping about `memory` bytes (0 for the default) in the working set.
+	// Returns 0 on success and -1 with errno set, EINVAL when result_path is
+	// one of the operands (it is truncated on creation); stats may be NULL.
+	int bigint_multiply_files(const char *a_path, const char *b_path, const char *result_path, size_t memory, BigIntDiskStats *stats)
+	{
+		BigIntDiskStats st;
+		memset(&st, 0, sizeof(st));
+		u64 io_read, io_written;
+		disk_io(&io_read, &io_written);
+		FILE *clear = fopen("/proc/self/clear_refs", "w"); // restarts the VmHWM count
+		if (clear)
+		{
+			fputs("5", clear);
+			fclose(clear);
+		}
+
+		BigIntMap a, b, r;
+		a.limbs = b.limbs = r.limbs = NULL;
+		a.fd = b.fd = r.fd = -1;
+		if (disk_map(&a, a_path, 0, 0) < 0 || disk_map(&b, b_path, 0, 0) < 0)
+		{
+			int err = errno;
+			disk_unmap(&a);
+			disk_unmap(&b);
+			errno = err;
+			return -1;
+		}
+		size_t an = a.size, bn = b.size;
+		while (an > 0 && a.limbs[an - 1] == 0)
+			an--;
+		while (bn > 0 && b.limbs[bn - 1] == 0)
+			bn--;
+		// creating the product truncates its file, which must not be an operand
+		int same = disk_same_file(result_path, a.fd) || disk_same_file(result_path, b.fd);
+		if (same || disk_map(&r, result_path, an + bn, 1) < 0)
+		{
+			int err = same ? EINVAL : errno;
+			disk_unmap(&a);
+			disk_unmap(&b);
+			disk_unmap(&r);
+			errno = err;
+			return -1;
+		}
+
+		if (an > 0 && bn > 0)
+		{
+			size_t block = disk_block(memory, an, bn), rn = an + bn;
+			size_t na = (an + block - 1) / block, nb = (bn + block - 1) / block;
+			int width = (int)(2 * block + 1);
+			BigIntArenaMark mark = scratch_mark();
+			u64 *tp = scratch_alloc(2 * block), *acc = scratch_alloc(width);
+			memset(acc, 0, width * sizeof(u64));
+			for (size_t k = 0; k < na + nb - 1; k++)
+			{
+				size_t lo = k >= nb ? k - nb + 1 : 0, hi = k < na ? k : na - 1;
+				for (size_t i = lo; i <= hi; i++)
+				{
+					size_t j = k - i;
+					const u64 *ap = a.limbs + i * block, *bp = b.limbs + j * block;
+					int x = (int)(an - i * block < block ? an - i * block : block);
+					int y = (int)(bn - j * block < block ? bn - j * block : block);
+					limbs_mul(tp, ap, x, bp, y);
+					limbs_add(acc, acc, width, tp, x + y);
+					disk_drop(ap, x);
+					disk_drop(bp, y);
+					st.bytes_read += (u64)(x + y) * sizeof(u64);
+				}
+				// nothing later reaches below limb (k + 1) * block
+				u64 *out = r.limbs + k * block;
+				size_t n = rn - k * block < block ? rn - k * block : block;
+				memcpy(out, acc, n * sizeof(u64));
+				disk_drop(out, n);
+				st.bytes_written += n * sizeof(u64);
+				memmove(acc, acc + block, (block + 1) * sizeof(u64));
+				memset(acc + block + 1, 0, block * sizeof(u64));
+			}
+			size_t done = (na + nb - 1) * block;
+			if (done < rn)
+			{
+				memcpy(r.limbs + done, acc, (rn - done) * sizeof(u64));
+				st.bytes_written += (rn - done) * sizeof(u64);
+			}
+			scratch_release(mark);
+			st.block = block;
+		}
+		disk_unmap(&a);
+		disk_unmap(&b);
+		disk_unmap(&r);
+
+		st.peak_rss = disk_peak_rss();
+		disk_io(&st.disk_read, &st.disk_written);
+		st.disk_read -= io_read;
+		st.disk_written -= io_written;
+		if (stats)
+			*stats = st;
+		return 0;
+	}
+#endif
+
+	// ---------- Autotuning ----------
+	// bigint_tune times both sides of each cutoff on this machine and writes
+	// the results as a bigint_tuned.h. Like GMP's tuneup it compares, at a
+	// sweep of sizes n, the lower tier against the upper tier used for the
+	// top level only (cutoff n + 1 versus n); the cutoff is the first size
+	// from which the upper tier wins three sweep steps in a row. Tiers are
+	// tuned from the bottom up with the ones above parked out of reach, and
+	// on one thread, so the crossovers are per core.
+
+	static double tune_seconds(void)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Best of three runs of at least a millisecond each, per call
+	template <class F>
+	static double tune_time(const F &fn)
+	{
+		double best = 1e30;
+		for (int rep = 0; rep < 3; rep++)
+		{
+			int calls = 0;
+			double start = tune_seconds(), elapsed;
+			do
+			{
+				fn();
+				calls++;
+			} while ((elapsed = tune_seconds() - start) < 1e-3);
+			if (elapsed / calls < best)
+				best = elapsed / calls;
+		}
+		return best;
+	}
+
+	// op(n) performs one operation of size n under the current cutoffs
+	template <class F>
+	static int tune_crossover(int id, int lo, int hi, const F &op)
+	{
+		int first = hi, wins = 0;
+		for (int n = lo; n < hi; n += n / 16 > 1 ? n / 16 : 1)
+		{
+			tuning[id] = n + 1;
+			double lower = tune_time([&] { op(n); });
+			tuning[id] = n;
+			double upper = tune_time([&] { op(n); });
+			if (upper < lower)
+			{
+				if (wins++ == 0)
+					first = n;
+				if (wins == 3)
+					break;
+			}
+			else
+				wins = 0;
+		}
+		tuning[id] = wins == 3 ? first : hi;
+		fprintf(stderr, "%s = %d\n", tuning_names[id], tuning[id]);
+		return tuning[id];
+	}
+
+	void bigint_tune(FILE *out)
+	{
+		const int park = INT_MAX / 4;
+		int threads = bigint_get_threads();
+		bigint_set_threads(1);
+
+		int max_n = 16384;
+		u64 *buf = (u64 *)malloc(8 * (size_t)max_n * sizeof(u64));
+		if (!buf)
+		{
+			fprintf(stderr, "Memory allocation failed\n");
+			exit(EXIT_FAILURE);
+		}
+		u64 *ap = buf, *bp = buf + max_n, *rp = buf + 2 * max_n;
+		u64 seed = 0x9E3779B97F4A7C15ULL;
+		for (int i = 0; i < 2 * max_n; i++)
+		{
+			seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+			buf[i] = seed;
+		}
+		auto mul = [&](int n) { limbs_mul(rp, ap, n, bp, n); };
+		auto sqr = [&](int n) { limbs_sqr(rp, ap, n); };
+
+		for (int i = TUNE_TOOM3; i <= TUNE_SQR_NTT; i++)
+			tuning[i] = park;
+		int k = tune_crossover(TUNE_KARATSUBA, 4, 200, mul);
+		int t = tune_crossover(TUNE_TOOM3, k > 8 ? k : 8, 1500, mul);
+		tune_crossover(TUNE_NTT, t, max_n, mul);
+
+		int b = tune_crossover(TUNE_SQR_BASECASE, 1, 100, sqr);
+		k = tune_crossover(TUNE_SQR_KARATSUBA, b > 4 ? b : 4, 300, sqr);
+		t = tune_crossover(TUNE_SQR_TOOM3, k > 8 ? k : 8, 1500, sqr);
+		tune_crossover(TUNE_SQR_NTT, t, max_n, sqr);
+
+		// 2n by n limbs, Knuth against the Newton reciprocal
+		BigInt num, den, q, r;
+		bigint_init(&num, 0);
+		bigint_init(&den, 0);
+		bigint_init(&q, 0);
+		bigint_init(&r, 0);
+		tune_crossover(TUNE_DIV_NEWTON, 100, 4000, [&](int n) {
+			bigint_import(&num, 2 * n, -1, sizeof(u64), 0, ap);
+			bigint_import(&den, n, -1, sizeof(u64), 0, bp);
+			bigint_divide(&num, &den, &q, &r);
+		});
+		bigint_free(&num);
+		bigint_free(&den);
+		bigint_free(&q);
+		bigint_free(&r);
+		free(buf);
+		bigint_set_threads(threads);
+
+		fprintf(out, "// Generated by `--tune` for the host it ran on. bigint.cpp picks this\n"
+					 "// up at build time, or at startup through BIGINT_TUNING=<this file>.\n");
+		for (int i = 0; i < TUNE_COUNT; i++)
+			fprintf(out, "#define TUNED_%s %d\n", tuning_names[i], tuning[i]);
+	}
+}
 namespace CPPBigInt
 {
-	// C++ program to implement
-	// the above approach
+	// C++ interface over the CBigInt engine: a non-negative integer stored
+	// as 64-bit limbs, with the arithmetic delegated to the CBigInt routines.
+	// The value is kept trimmed with at least one limb and sign 1.
+
+	template <int Bits>
+	struct UInt;
 
 	class BigInt
 	{
-		string digits;
+		CBigInt::BigInt value;
+
+		void normalize();
 
 	public:
 		// Constructors:
 		BigInt(unsigned long long n = 0);
-		BigInt(string &);
+		BigInt(const string &);
 		BigInt(const char *);
 		BigInt(const BigInt &);
+		BigInt(BigInt &&) noexcept;
+		~BigInt();
 
 		// Helper Functions:
 		friend void divide_by_2(BigInt &a);
@@ -27,6 +5522,7 @@ namespace CPPBigInt
 
 		// Direct assignment
 		BigInt &operator=(const BigInt &);
+		BigInt &operator=(BigInt &&) noexcept;
 
 		// Post/Pre - Incrementation
 		BigInt &operator++();
@@ -34,10 +5530,15 @@ namespace CPPBigInt
 		BigInt &operator--();
 		BigInt operator--(int temp);
 
-		// Addition and Subtraction
+		// Addition and Subtraction. The rvalue overloads compute into the
+		// dying operand's storage, so chains like a * b + c allocate once.
 		friend BigInt &operator+=(BigInt &, const BigInt &);
 		friend BigInt operator+(const BigInt &, const BigInt &);
+		friend BigInt operator+(BigInt &&, const BigInt &);
+		friend BigInt operator+(const BigInt &, BigInt &&);
+		friend BigInt operator+(BigInt &&, BigInt &&);
 		friend BigInt operator-(const BigInt &, const BigInt &);
+		friend BigInt operator-(BigInt &&, const BigInt &);
 		friend BigInt &operator-=(BigInt &, const BigInt &);
 
 		// Comparison operators
@@ -52,19 +5553,28 @@ namespace CPPBigInt
 		// Multiplication and Division
 		friend BigInt &operator*=(BigInt &, const BigInt &);
 		friend BigInt operator*(const BigInt &, const BigInt &);
+		friend BigInt operator*(BigInt &&, const BigInt &);
+		friend BigInt operator*(const BigInt &, BigInt &&);
+		friend BigInt operator*(BigInt &&, BigInt &&);
 		friend BigInt &operator/=(BigInt &, const BigInt &);
-		friend BigInt operator/(BigInt &, const BigInt &);
+		friend BigInt operator/(const BigInt &, const BigInt &);
+		friend BigInt operator/(BigInt &&, const BigInt &);
 
 		// Modulo
 		friend BigInt operator%(const BigInt &, const BigInt &);
+		friend BigInt operator%(BigInt &&, const BigInt &);
 		friend BigInt &operator%=(BigInt &, const BigInt &);
 
 		// Power Function
 		friend BigInt &operator^=(BigInt &, const BigInt &);
-		friend BigInt operator^(BigInt &, const BigInt &);
+		friend BigInt operator^(const BigInt &, const BigInt &);
+		friend BigInt operator^(BigInt &&, const BigInt &);
 
-		// Square Root Function
-		friend BigInt sqrt(BigInt &a);
+		// Roots: floor of the square / k-th root; sqrtrem also returns
+		// a - root^2, zero exactly for perfect squares
+		friend BigInt sqrt(const BigInt &a);
+		friend BigInt sqrtrem(const BigInt &a, BigInt &rem);
+		friend BigInt root(const BigInt &a, unsigned long k);
 
 		// Read and Write
 		friend ostream &operator<<(ostream &, const BigInt &);
@@ -74,61 +5584,89 @@ namespace CPPBigInt
 		friend BigInt NthCatalan(int n);
 		friend BigInt NthFibonacci(int n);
 		friend BigInt Factorial(int n);
+
+		template <int Bits>
+		friend struct UInt;
 	};
 
-	BigInt::BigInt(string &s)
+	void BigInt::normalize()
 	{
-		digits = "";
-		int n = s.size();
-		for (int i = n - 1; i >= 0; i--)
+		while (value.size > 1 && value.limbs[value.size - 1] == 0)
+			value.size--;
+		if (value.size == 0)
 		{
-			if (!isdigit(s[i]))
-				throw("ERROR");
-			digits.push_back(s[i] - '0');
+			value.limbs[0] = 0;
+			value.size = 1;
 		}
+		value.sign = 1;
+	}
+
+	BigInt::BigInt(const string &s)
+	{
+		for (char c : s)
+			if (!isdigit(c))
+				throw("ERROR");
+		CBigInt::bigint_from_string(&value, s.c_str());
+		normalize();
 	}
 	BigInt::BigInt(unsigned long long nr)
 	{
-		do
-		{
-			digits.push_back(nr % 10);
-			nr /= 10;
-		} while (nr);
+		CBigInt::bigint_init(&value, 0);
+		value.limbs[0] = nr;
+		value.size = 1;
+		normalize();
 	}
 	BigInt::BigInt(const char *s)
 	{
-		digits = "";
-		for (int i = strlen(s) - 1; i >= 0; i--)
-		{
-			if (!isdigit(s[i]))
+		for (const char *p = s; *p; p++)
+			if (!isdigit(*p))
 				throw("ERROR");
-			digits.push_back(s[i] - '0');
-		}
+		CBigInt::bigint_from_string(&value, s);
+		normalize();
 	}
 	BigInt::BigInt(const BigInt &a)
 	{
-		digits = a.digits;
+		CBigInt::bigint_init(&value, 0);
+		CBigInt::bigint_copy(&value, &a.value);
+	}
+	// Takes the storage; a is left holding zero
+	BigInt::BigInt(BigInt &&a) noexcept
+	{
+		CBigInt::bigint_init(&value, 0);
+		CBigInt::bigint_swap(&value, &a.value);
+		a.normalize();
+	}
+	BigInt::~BigInt()
+	{
+		CBigInt::bigint_free(&value);
 	}
 
 	bool Null(const BigInt &a)
 	{
-		if (a.digits.size() == 1 && a.digits[0] == 0)
-			return true;
-		return false;
+		return a.value.size == 1 && a.value.limbs[0] == 0;
 	}
 	int Length(const BigInt &a)
 	{
-		return a.digits.size();
+		char *s = CBigInt::to_string(&a.value);
+		int n = strlen(s);
+		free(s);
+		return n;
 	}
+	// Decimal digit at position index, counted from the least significant
 	int BigInt::operator[](const int index) const
 	{
-		if (digits.size() <= index || index < 0)
+		char *s = CBigInt::to_string(&value);
+		int n = strlen(s);
+		int digit = (index >= 0 && index < n) ? s[n - 1 - index] - '0' : -1;
+		free(s);
+		if (digit < 0)
 			throw("ERROR");
-		return digits[index];
+		return digit;
 	}
 	bool operator==(const BigInt &a, const BigInt &b)
 	{
-		return a.digits == b.digits;
+		return a.value.size == b.value.size &&
+			   memcmp(a.value.limbs, b.value.limbs, a.value.size * sizeof(CBigInt::u64)) == 0;
 	}
 	bool operator!=(const BigInt &a, const BigInt &b)
 	{
@@ -136,13 +5674,7 @@ namespace CPPBigInt
 	}
 	bool operator<(const BigInt &a, const BigInt &b)
 	{
-		int n = Length(a), m = Length(b);
-		if (n != m)
-			return n < m;
-		while (n--)
-			if (a.digits[n] != b.digits[n])
-				return a.digits[n] < b.digits[n];
-		return false;
+		return CBigInt::bigint_compare(&a.value, &b.value) < 0;
 	}
 	bool operator>(const BigInt &a, const BigInt &b)
 	{
@@ -159,19 +5691,26 @@ namespace CPPBigInt
 
 	BigInt &BigInt::operator=(const BigInt &a)
 	{
-		digits = a.digits;
+		CBigInt::bigint_copy(&value, &a.value);
+		return *this;
+	}
+	// Swaps storage; a's old buffer goes when a does
+	BigInt &BigInt::operator=(BigInt &&a) noexcept
+	{
+		CBigInt::bigint_swap(&value, &a.value);
 		return *this;
 	}
 
 	BigInt &BigInt::operator++()
 	{
-		int i, n = digits.size();
-		for (i = 0; i < n && digits[i] == 9; i++)
-			digits[i] = 0;
+		int i, n = value.size;
+		for (i = 0; i < n && ++value.limbs[i] == 0; i++)
+			;
 		if (i == n)
-			digits.push_back(1);
-		else
-			digits[i]++;
+		{
+			CBigInt::bigint_reserve(&value, n + 1);
+			value.limbs[value.size++] = 1;
+		}
 		return *this;
 	}
 	BigInt BigInt::operator++(int temp)
@@ -184,14 +5723,11 @@ namespace CPPBigInt
 
 	BigInt &BigInt::operator--()
 	{
-		if (digits[0] == 0 && digits.size() == 1)
+		if (Null(*this))
 			throw("UNDERFLOW");
-		int i, n = digits.size();
-		for (i = 0; digits[i] == 0 && i < n; i++)
-			digits[i] = 9;
-		digits[i]--;
-		if (n > 1 && digits[n - 1] == 0)
-			digits.pop_back();
+		for (int i = 0; value.limbs[i]-- == 0; i++)
+			;
+		normalize();
 		return *this;
 	}
 	BigInt BigInt::operator--(int temp)
@@ -204,279 +5740,248 @@ namespace CPPBigInt
 
 	BigInt &operator+=(BigInt &a, const BigInt &b)
 	{
-		int t = 0, s, i;
-		int n = Length(a), m = Length(b);
-		if (m > n)
-			a.digits.append(m - n, 0);
-		n = Length(a);
-		for (i = 0; i < n; i++)
-		{
-			if (i < m)
-				s = (a.digits[i] + b.digits[i]) + t;
-			else
-				s = a.digits[i] + t;
-			t = s / 10;
-			a.digits[i] = (s % 10);
-		}
-		if (t)
-			a.digits.push_back(t);
+		CBigInt::bigint_add(&a.value, &b.value, &a.value);
+		a.normalize();
 		return a;
 	}
 	BigInt operator+(const BigInt &a, const BigInt &b)
 	{
 		BigInt temp;
-		temp = a;
-		temp += b;
+		CBigInt::bigint_add(&a.value, &b.value, &temp.value);
+		temp.normalize();
 		return temp;
 	}
+	BigInt operator+(BigInt &&a, const BigInt &b)
+	{
+		a += b;
+		return std::move(a);
+	}
+	BigInt operator+(const BigInt &a, BigInt &&b)
+	{
+		b += a;
+		return std::move(b);
+	}
+	BigInt operator+(BigInt &&a, BigInt &&b)
+	{
+		a += b;
+		return std::move(a);
+	}
 
 	BigInt &operator-=(BigInt &a, const BigInt &b)
 	{
 		if (a < b)
 			throw("UNDERFLOW");
-		int n = Length(a), m = Length(b);
-		int i, t = 0, s;
-		for (i = 0; i < n; i++)
-		{
-			if (i < m)
-				s = a.digits[i] - b.digits[i] + t;
-			else
-				s = a.digits[i] + t;
-			if (s < 0)
-				s += 10,
-					t = -1;
-			else
-				t = 0;
-			a.digits[i] = s;
-		}
-		while (n > 1 && a.digits[n - 1] == 0)
-			a.digits.pop_back(),
-				n--;
+		CBigInt::bigint_subtract(&a.value, &b.value, &a.value);
+		a.normalize();
 		return a;
 	}
 	BigInt operator-(const BigInt &a, const BigInt &b)
 	{
+		if (a < b)
+			throw("UNDERFLOW");
 		BigInt temp;
-		temp = a;
-		temp -= b;
+		CBigInt::bigint_subtract(&a.value, &b.value, &temp.value);
+		temp.normalize();
 		return temp;
 	}
+	BigInt operator-(BigInt &&a, const BigInt &b)
+	{
+		a -= b;
+		return std::move(a);
+	}
 
 	BigInt &operator*=(BigInt &a, const BigInt &b)
 	{
-		if (Null(a) || Null(b))
-		{
-			a = BigInt();
-			return a;
-		}
-		int n = a.digits.size(), m = b.digits.size();
-		vector<int> v(n + m, 0);
-		for (int i = 0; i < n; i++)
-			for (int j = 0; j < m; j++)
-			{
-				v[i + j] += (a.digits[i]) * (b.digits[j]);
-			}
-		n += m;
-		a.digits.resize(v.size());
-		for (int s, i = 0, t = 0; i < n; i++)
-		{
-			s = t + v[i];
-			v[i] = s % 10;
-			t = s / 10;
-			a.digits[i] = v[i];
-		}
-		for (int i = n - 1; i >= 1 && !v[i]; i--)
-			a.digits.pop_back();
+		CBigInt::bigint_multiply(&a.value, &b.value, &a.value);
+		a.normalize();
 		return a;
 	}
 	BigInt operator*(const BigInt &a, const BigInt &b)
 	{
 		BigInt temp;
-		temp = a;
-		temp *= b;
+		CBigInt::bigint_multiply(&a.value, &b.value, &temp.value);
+		temp.normalize();
 		return temp;
 	}
+	BigInt operator*(BigInt &&a, const BigInt &b)
+	{
+		a *= b;
+		return std::move(a);
+	}
+	BigInt operator*(const BigInt &a, BigInt &&b)
+	{
+		b *= a;
+		return std::move(b);
+	}
+	BigInt operator*(BigInt &&a, BigInt &&b)
+	{
+		a *= b;
+		return std::move(a);
+	}
 
 	BigInt &operator/=(BigInt &a, const BigInt &b)
 	{
 		if (Null(b))
 			throw("Arithmetic Error: Division By 0");
-		if (a < b)
-		{
-			a = BigInt();
-			return a;
-		}
-		if (a == b)
-		{
-			a = BigInt(1);
-			return a;
-		}
-		int i, lgcat = 0, cc;
-		int n = Length(a); //, m = Length(b);
-		vector<int> cat(n, 0);
-		BigInt t;
-		for (i = n - 1; t * 10 + a.digits[i] < b; i--)
-		{
-			t *= 10;
-			t += a.digits[i];
-		}
-		for (; i >= 0; i--)
-		{
-			t = t * 10 + a.digits[i];
-			for (cc = 9; cc * b > t; cc--)
-				;
-			t -= cc * b;
-			cat[lgcat++] = cc;
-		}
-		a.digits.resize(cat.size());
-		for (i = 0; i < lgcat; i++)
-			a.digits[i] = cat[lgcat - i - 1];
-		a.digits.resize(lgcat);
+		CBigInt::bigint_divide(&a.value, &b.value, &a.value, NULL);
+		a.normalize();
 		return a;
 	}
 	BigInt operator/(const BigInt &a, const BigInt &b)
 	{
+		if (Null(b))
+			throw("Arithmetic Error: Division By 0");
 		BigInt temp;
-		temp = a;
-		temp /= b;
+		CBigInt::bigint_divide(&a.value, &b.value, &temp.value, NULL);
+		temp.normalize();
 		return temp;
 	}
+	BigInt operator/(BigInt &&a, const BigInt &b)
+	{
+		a /= b;
+		return std::move(a);
+	}
+
+	// The last multi-limb divisor is remembered per thread. When the same
+	// divisor comes straight back, a Barrett context is built for it and
+	// reused for as long as it keeps repeating.
+	struct ModCache
+	{
+		CBigInt::BigInt divisor;
+		CBigInt::BigIntBarrett ctx;
+		bool ready;
+		ModCache() : ready(false) { CBigInt::bigint_init(&divisor, 0); }
+		~ModCache()
+		{
+			if (ready)
+				CBigInt::bigint_barrett_free(&ctx);
+			CBigInt::bigint_free(&divisor);
+		}
+	};
+	static thread_local ModCache mod_cache;
 
 	BigInt &operator%=(BigInt &a, const BigInt &b)
 	{
 		if (Null(b))
 			throw("Arithmetic Error: Division By 0");
-		if (a < b)
-		{
-			return a;
-		}
-		if (a == b)
-		{
-			a = BigInt();
-			return a;
-		}
-		int i, lgcat = 0, cc;
-		int n = Length(a); //, m = Length(b);
-		vector<int> cat(n, 0);
-		BigInt t;
-		for (i = n - 1; t * 10 + a.digits[i] < b; i--)
+		const CBigInt::BigInt &d = mod_cache.divisor;
+		if (b.value.size < 2)
+			CBigInt::bigint_divide(&a.value, &b.value, NULL, &a.value);
+		else if (d.size == b.value.size &&
+				 memcmp(d.limbs, b.value.limbs, d.size * sizeof(CBigInt::u64)) == 0)
 		{
-			t *= 10;
-			t += a.digits[i];
+			if (!mod_cache.ready)
+			{
+				CBigInt::bigint_barrett_init(&mod_cache.ctx, &d);
+				mod_cache.ready = true;
+			}
+			CBigInt::bigint_barrett_reduce(&mod_cache.ctx, &a.value, &a.value);
 		}
-		for (; i >= 0; i--)
+		else
 		{
-			t = t * 10 + a.digits[i];
-			for (cc = 9; cc * b > t; cc--)
-				;
-			t -= cc * b;
-			cat[lgcat++] = cc;
+			if (mod_cache.ready)
+				CBigInt::bigint_barrett_free(&mod_cache.ctx);
+			mod_cache.ready = false;
+			CBigInt::bigint_copy(&mod_cache.divisor, &b.value);
+			CBigInt::bigint_divide(&a.value, &b.value, NULL, &a.value);
 		}
-		a = t;
+		a.normalize();
 		return a;
 	}
 	BigInt operator%(const BigInt &a, const BigInt &b)
 	{
-		BigInt temp;
-		temp = a;
+		BigInt temp(a);
 		temp %= b;
 		return temp;
 	}
+	BigInt operator%(BigInt &&a, const BigInt &b)
+	{
+		a %= b;
+		return std::move(a);
+	}
 
 	BigInt &operator^=(BigInt &a, const BigInt &b)
 	{
-		BigInt Exponent, Base(a);
-		Exponent = b;
+		if (&a == &b)
+		{
+			BigInt e(b);
+			return a ^= e;
+		}
+		BigInt Base(std::move(a));
 		a = 1;
-		while (!Null(Exponent))
+		int bits = CBigInt::bigint_bit_length(&b.value);
+		for (int bit = 0; bit < bits; bit++)
 		{
-			if (Exponent[0] & 1)
+			if (CBigInt::bigint_test_bit(&b.value, bit))
 				a *= Base;
-			Base *= Base;
-			divide_by_2(Exponent);
+			if (bit + 1 < bits)
+				Base *= Base;
 		}
 		return a;
 	}
-	BigInt operator^(BigInt &a, BigInt &b)
+	BigInt operator^(const BigInt &a, const BigInt &b)
 	{
 		BigInt temp(a);
 		temp ^= b;
 		return temp;
 	}
+	BigInt operator^(BigInt &&a, const BigInt &b)
+	{
+		a ^= b;
+		return std::move(a);
+	}
 
 	void divide_by_2(BigInt &a)
 	{
-		int add = 0;
-		for (int i = a.digits.size() - 1; i >= 0; i--)
-		{
-			int digit = (a.digits[i] >> 1) + add;
-			add = ((a.digits[i] & 1) * 5);
-			a.digits[i] = digit;
-		}
-		while (a.digits.size() > 1 && !a.digits.back())
-			a.digits.pop_back();
+		CBigInt::bigint_shift_right(&a.value, 1);
+		a.normalize();
 	}
 
-	BigInt sqrt(BigInt &a)
+	BigInt sqrt(const BigInt &a)
 	{
-		BigInt left(1), right(a), v(1), mid, prod;
-		divide_by_2(right);
-		while (left <= right)
-		{
-			mid += left;
-			mid += right;
-			divide_by_2(mid);
-			prod = (mid * mid);
-			if (prod <= a)
-			{
-				v = mid;
-				++mid;
-				left = mid;
-			}
-			else
-			{
-				--mid;
-				right = mid;
-			}
-			mid = BigInt();
-		}
-		return v;
+		BigInt r;
+		CBigInt::bigint_sqrt(&a.value, &r.value);
+		return r;
+	}
+	BigInt sqrtrem(const BigInt &a, BigInt &rem)
+	{
+		BigInt r;
+		CBigInt::bigint_sqrtrem(&a.value, &r.value, &rem.value);
+		return r;
+	}
+	BigInt root(const BigInt &a, unsigned long k)
+	{
+		if (k == 0)
+			throw("Arithmetic Error: Zeroth Root");
+		BigInt r;
+		CBigInt::bigint_root(&a.value, k, &r.value);
+		return r;
 	}
 
 	BigInt NthCatalan(int n)
 	{
-		BigInt a(1), b;
-		for (int i = 2; i <= n; i++)
-			a *= i;
-		b = a;
-		for (int i = n + 1; i <= 2 * n; i++)
-			b *= i;
-		a *= a;
-		a *= (n + 1);
-		b /= a;
-		return b;
+		if (n < 0)
+			throw("ERROR");
+		BigInt c;
+		CBigInt::bigint_catalan(n, &c.value);
+		return c;
 	}
 
 	BigInt NthFibonacci(int n)
 	{
-		BigInt a(1), b(1), c;
-		if (!n)
-			return c;
-		n--;
-		while (n--)
-		{
-			c = a + b;
-			b = a;
-			a = c;
-		}
-		return b;
+		if (n < 0)
+			throw("ERROR");
+		BigInt f;
+		CBigInt::bigint_fibonacci(n, &f.value);
+		f.normalize();
+		return f;
 	}
 
 	BigInt Factorial(int n)
 	{
 		BigInt f(1);
-		for (int i = 2; i <= n; i++)
-			f *= i;
+		if (n > 1)
+			CBigInt::bigint_factorial(n, &f.value);
 		return f;
 	}
 
@@ -484,510 +5989,397 @@ namespace CPPBigInt
 	{
 		string s;
 		in >> s;
-		int n = s.size();
-		for (int i = n - 1; i >= 0; i--)
-		{
-			if (!isdigit(s[i]))
-				throw("INVALID NUMBER");
-			a.digits[n - i - 1] = s[i];
-		}
+		a = BigInt(s);
 		return in;
 	}
 
 	ostream &operator<<(ostream &out, const BigInt &a)
 	{
-		for (int i = a.digits.size() - 1; i >= 0; i--)
-			out << (short)a.digits[i];
+		char *s = CBigInt::to_string(&a.value);
+		out << s;
+		free(s);
 		return out;
 	}
 
-}
-namespace CBigInt
-{
-
-// This code is a C implementation of a BigInt library using u64
-// to represent large integers. It includes functions for
-// initialization, addition, multiplication, division, and printing
-// as string. It also includes a function to convert a string
-// representation of a number into a BigInt. The library is
-// designed to handle very large integers that cannot be
-// represented by standard data types like int or long long.
-#include <stdio.h>
-#include <stdint.h>
-#include <stdlib.h>
-#include <string.h>
-#include <limits.h>
-#include <inttypes.h>
-
-#define CHUNK_BASE 1000000000ULL
-#define CHUNK_DIGITS 9
-#define BASE 10
-
-	typedef unsigned long long u64;
-	const u64 MAX_BASE = UINT64_MAX;
-
-	typedef struct
-	{
-		u64 *limbs;
-		int size;
-		int capacity;
-		int sign;
-	} BigInt;
-
-	// ---------- Memory Helpers ----------
-	void bigint_reserve(BigInt *num, int required)
-	{
-		if (required <= num->capacity)
-			return;
-
-		int new_cap = (num->capacity > 0) ? num->capacity * 2 : 4;
-		while (new_cap < required)
-			new_cap *= 2;
-
-		num->limbs = (u64 *)realloc(num->limbs, new_cap * sizeof(u64));
-		if (!num->limbs)
-		{
-			fprintf(stderr, "Memory allocation failed\n");
-			exit(EXIT_FAILURE);
-		}
-		memset(num->limbs + num->capacity, 0, (new_cap - num->capacity) * sizeof(u64));
-		num->capacity = new_cap;
-	}
-
-	void bigint_free(BigInt *num)
-	{
-		if (num->limbs)
-		{
-			free(num->limbs);
-			num->limbs = NULL;
-		}
-		num->size = 0;
-		num->capacity = 0;
-		num->sign = 0;
-	}
-
-	void bigint_copy(BigInt *dst, const BigInt *src)
-	{
-		bigint_reserve(dst, src->size);
-		memcpy(dst->limbs, src->limbs, src->size * sizeof(u64));
-		dst->size = src->size;
-		dst->sign = src->sign;
-	}
-
-	// ---------- Initialization ----------
-	void bigint_init(BigInt *num, long long value)
-	{
-		num->limbs = NULL;
-		num->size = 0;
-		num->capacity = 0;
-		num->sign = 0;
-		bigint_reserve(num, 1);
-
-		num->limbs[0] = (u64)((value < 0) ? -value : value);
-		num->size = (value != 0) ? 1 : 0;
-		num->sign = (value < 0) ? -1 : 1;
-	}
-
-	// ---------- Basic Utilities ----------
-	int bigint_compare(const BigInt *a, const BigInt *b)
-	{
-		if (a->sign != b->sign)
-			return (a->sign < b->sign) ? -1 : 1;
-		if (a->size != b->size)
-			return (a->size < b->size) ? -1 : 1;
-
-		for (int i = a->size - 1; i >= 0; --i)
-		{
-			if (a->limbs[i] != b->limbs[i])
-				return (a->limbs[i] < b->limbs[i]) ? -1 : 1;
-		}
-		return 0;
-	}
-
-	// ---------- Arithmetic ----------
-	void bigint_add(const BigInt *a, const BigInt *b, BigInt *result);
-	void bigint_subtract(const BigInt *a, const BigInt *b, BigInt *result);
-
-	void bigint_add_u64(const BigInt *a, u64 b, BigInt *result)
+	// ---------- Fixed-Width Integers ----------
+	// UInt<Bits> is an unsigned integer of exactly Bits bits (a multiple of
+	// 64) held in a std::array of little-endian limbs: no heap, trivially
+	// copyable, and at the small widths kept in registers by the compiler.
+	// Arithmetic wraps modulo 2^Bits. Every operation is constexpr over the
+	// fixed limb count, which GCC unrolls completely; at run time widths of
+	// UINT_KERNEL_LIMBS limbs and up call the CBigInt limb kernels instead,
+	// where the adc/mulx loops beat the unrolled code.
+#define UINT_KERNEL_LIMBS 16
+
+	template <int Bits>
+	struct UInt
 	{
-		bigint_copy(result, a);
-		bigint_reserve(result, result->size + 1);
+		static_assert(Bits > 0 && Bits % 64 == 0, "UInt width must be a positive multiple of 64 bits");
+		typedef CBigInt::u64 u64;
+		static constexpr int N = Bits / 64;
 
-		u64 carry = b;
-		for (int i = 0; i < result->size && carry > 0; ++i)
-		{
-			u64 sum = result->limbs[i] + carry;
-			carry = (sum < result->limbs[i]) ? 1 : 0;
-			result->limbs[i] = sum;
-		}
-		if (carry > 0)
-		{
-			result->limbs[result->size++] = carry;
-		}
-	}
+		std::array<u64, N> limbs{};
 
-	void bigint_multiply_u64(const BigInt *a, u64 b, BigInt *result)
-	{
-		if (b == 0 || a->size == 0)
-		{
-			bigint_reserve(result, 1);
-			result->limbs[0] = 0;
-			result->size = 1;
-			result->sign = 0;
-			return;
-		}
+		constexpr UInt() = default;
+		constexpr UInt(u64 v) { limbs[0] = v; }
 
-		bigint_reserve(result, a->size + 1);
-		u64 carry = 0;
-		for (int i = 0; i < a->size; ++i)
-		{
-			__uint128_t prod = (__uint128_t)a->limbs[i] * b + carry;
-			result->limbs[i] = (u64)prod;
-			carry = (u64)(prod >> 64);
-		}
-		if (carry)
-		{
-			result->limbs[a->size] = carry;
-			result->size = a->size + 1;
-		}
-		else
+		// The low Bits bits of |x|
+		explicit UInt(const CBigInt::BigInt *x)
 		{
-			result->size = a->size;
+			for (int i = 0; i < N && i < x->size; i++)
+				limbs[i] = x->limbs[i];
 		}
-		result->sign = a->sign;
-	}
-
-	void bigint_subtract(const BigInt *a, const BigInt *b, BigInt *result)
-	{
-		BigInt temp_a, temp_b;
-		bigint_init(&temp_a, 0);
-		bigint_init(&temp_b, 0);
-		bigint_copy(&temp_a, a);
-		bigint_copy(&temp_b, b);
-		temp_a.sign = temp_b.sign = 1;
+		explicit UInt(const BigInt &x) : UInt(&x.value) {}
 
-		if (bigint_compare(&temp_a, &temp_b) < 0)
+		// x = this; x must be initialized
+		void to_bigint(CBigInt::BigInt *x) const
 		{
-			bigint_subtract(&temp_b, &temp_a, result);
-			result->sign = -1;
-			bigint_free(&temp_a);
-			bigint_free(&temp_b);
-			return;
+			CBigInt::bigint_import(x, N, -1, sizeof(u64), 0, limbs.data());
 		}
-
-		bigint_reserve(result, a->size);
-		u64 borrow = 0;
-		for (int i = 0; i < a->size; ++i)
+		explicit operator BigInt() const
 		{
-			__int128 diff = (__int128)a->limbs[i] -
-							(i < b->size ? b->limbs[i] : 0) - borrow;
-			borrow = (diff < 0) ? 1 : 0;
-			diff += borrow * ((__int128)1 << 64);
-			result->limbs[i] = (u64)diff;
+			BigInt r;
+			to_bigint(&r.value);
+			r.normalize();
+			return r;
 		}
-		result->size = a->size;
-		while (result->size > 1 && result->limbs[result->size - 1] == 0)
-			result->size--;
-		result->sign = 1;
 
-		bigint_free(&temp_a);
-		bigint_free(&temp_b);
-	}
-
-	void bigint_add(const BigInt *a, const BigInt *b, BigInt *result)
-	{
-		if (a->size == 0)
-		{
-			bigint_copy(result, b);
-			return;
-		}
-		if (b->size == 0)
+		static constexpr bool kernels()
 		{
-			bigint_copy(result, a);
-			return;
+			return N >= UINT_KERNEL_LIMBS && !__builtin_is_constant_evaluated();
 		}
 
-		if (a->sign == 1 && b->sign == -1)
-		{
-			BigInt temp;
-			bigint_init(&temp, 0);
-			bigint_copy(&temp, b);
-			temp.sign = 1;
-			bigint_subtract(a, &temp, result);
-			bigint_free(&temp);
-			return;
-		}
-		if (a->sign == -1 && b->sign == 1)
-		{
-			BigInt temp;
-			bigint_init(&temp, 0);
-			bigint_copy(&temp, a);
-			temp.sign = 1;
-			bigint_subtract(b, &temp, result);
-			bigint_free(&temp);
-			return;
-		}
-		if (a->sign == -1 && b->sign == -1)
+		// r = a + b mod 2^Bits, returns the carry out; r may alias a or b
+		static constexpr u64 add(UInt &r, const UInt &a, const UInt &b)
 		{
-			BigInt temp;
-			bigint_init(&temp, 0);
-			temp.sign = 1;
-			bigint_add(a, b, &temp);
-			temp.sign = -1;
-			bigint_copy(result, &temp);
-			bigint_free(&temp);
-			return;
+			if (kernels())
+				return CBigInt::limbs_add_n(r.limbs.data(), a.limbs.data(), b.limbs.data(), N);
+			u64 carry = 0;
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+			{
+				unsigned __int128 s = (unsigned __int128)a.limbs[i] + b.limbs[i] + carry;
+				r.limbs[i] = (u64)s;
+				carry = (u64)(s >> 64);
+			}
+			return carry;
 		}
 
-		int max_size = (a->size > b->size) ? a->size : b->size;
-		bigint_reserve(result, max_size + 1);
-
-		u64 carry = 0;
-		int i;
-		for (i = 0; i < max_size; ++i)
+		// r = a - b mod 2^Bits, returns the borrow out; r may alias a or b
+		static constexpr u64 sub(UInt &r, const UInt &a, const UInt &b)
 		{
-			__uint128_t sum = (__uint128_t)(i < a->size ? a->limbs[i] : 0) +
-							  (i < b->size ? b->limbs[i] : 0) + carry;
-			result->limbs[i] = (u64)sum;
-			carry = (u64)(sum >> 64);
+			if (kernels())
+				return CBigInt::limbs_sub_n(r.limbs.data(), a.limbs.data(), b.limbs.data(), N);
+			u64 borrow = 0;
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+			{
+				unsigned __int128 d = (unsigned __int128)a.limbs[i] - b.limbs[i] - borrow;
+				r.limbs[i] = (u64)d;
+				borrow = (u64)(d >> 64) & 1;
+			}
+			return borrow;
 		}
-		if (carry)
-			result->limbs[i++] = carry;
-		result->size = i;
-		result->sign = 1;
-	}
 
-	// ---------- Multiplication ----------
-	void bigint_multiply(const BigInt *a, const BigInt *b, BigInt *result)
-	{
-		if (a->size == 0 || b->size == 0 || (a->size == 1 && a->limbs[0] == 0) || (b->size == 1 && b->limbs[0] == 0))
+		// The full 2*Bits-bit product
+		static constexpr UInt<2 * Bits> mul_wide(const UInt &a, const UInt &b)
 		{
-			bigint_reserve(result, 1);
-			result->limbs[0] = 0;
-			result->size = 1;
-			result->sign = 0;
-			return;
+			UInt<2 * Bits> r;
+			if (kernels())
+			{
+				CBigInt::mul_basecase(r.limbs.data(), a.limbs.data(), N, b.limbs.data(), N);
+				return r;
+			}
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+			{
+				u64 carry = 0;
+#pragma GCC unroll 16
+				for (int j = 0; j < N; j++)
+				{
+					unsigned __int128 p = (unsigned __int128)a.limbs[j] * b.limbs[i] + r.limbs[i + j] + carry;
+					r.limbs[i + j] = (u64)p;
+					carry = (u64)(p >> 64);
+				}
+				r.limbs[i + N] = carry;
+			}
+			return r;
 		}
 
-		int result_size = a->size + b->size;
-		bigint_reserve(result, result_size);
-		memset(result->limbs, 0, result_size * sizeof(u64));
-		result->size = result_size;
-		result->sign = (a->sign == b->sign) ? 1 : -1;
-
-		for (int i = 0; i < a->size; i++)
+		// a * b mod 2^Bits: only the partial products below limb N
+		static constexpr UInt mul_low(const UInt &a, const UInt &b)
 		{
-			u64 carry = 0;
-			for (int j = 0; j < b->size || carry > 0; j++)
+			UInt r;
+			if (kernels())
 			{
-				__uint128_t product = (__uint128_t)a->limbs[i] *
-										  (j < b->size ? b->limbs[j] : 0) +
-									  result->limbs[i + j] + carry;
-				result->limbs[i + j] = (u64)product;
-				carry = (u64)(product >> 64);
+				CBigInt::limbs_mul_1(r.limbs.data(), a.limbs.data(), N, b.limbs[0]);
+				for (int i = 1; i < N; i++)
+					CBigInt::limbs_addmul_1(r.limbs.data() + i, a.limbs.data(), N - i, b.limbs[i]);
+				return r;
+			}
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+			{
+				u64 carry = 0;
+#pragma GCC unroll 16
+				for (int j = 0; j < N - i; j++)
+				{
+					unsigned __int128 p = (unsigned __int128)a.limbs[j] * b.limbs[i] + r.limbs[i + j] + carry;
+					r.limbs[i + j] = (u64)p;
+					carry = (u64)(p >> 64);
+				}
 			}
+			return r;
 		}
 
-		while (result->size > 1 && result->limbs[result->size - 1] == 0)
-			result->size--;
-	}
+		// -1, 0, 1 as a <, ==, > b
+		static constexpr int cmp(const UInt &a, const UInt &b)
+		{
+#pragma GCC unroll 16
+			for (int i = N - 1; i >= 0; i--)
+				if (a.limbs[i] != b.limbs[i])
+					return a.limbs[i] < b.limbs[i] ? -1 : 1;
+			return 0;
+		}
 
-	// ---------- Shift Left ----------
-	void bigint_shift_left(BigInt *num, int bits)
-	{
-		if (bits == 0 || num->size == 0)
-			return;
+		constexpr bool is_zero() const
+		{
+			u64 any = 0;
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+				any |= limbs[i];
+			return any == 0;
+		}
 
-		int limb_shift = bits / 64;
-		int bit_shift = bits % 64;
+		constexpr int bit_length() const
+		{
+			for (int i = N - 1; i >= 0; i--)
+				if (limbs[i])
+					return i * 64 + 64 - __builtin_clzll(limbs[i]);
+			return 0;
+		}
 
-		int new_size = num->size + limb_shift + (bit_shift ? 1 : 0);
-		bigint_reserve(num, new_size);
+		constexpr bool test_bit(int bit) const
+		{
+			return bit < Bits && (limbs[bit / 64] >> (bit % 64) & 1);
+		}
 
-		if (limb_shift > 0)
+		friend constexpr UInt operator+(const UInt &a, const UInt &b)
 		{
-			memmove(num->limbs + limb_shift, num->limbs, num->size * sizeof(u64));
-			memset(num->limbs, 0, limb_shift * sizeof(u64));
+			UInt r;
+			add(r, a, b);
+			return r;
 		}
-		if (bit_shift > 0)
+		friend constexpr UInt operator-(const UInt &a, const UInt &b)
 		{
-			u64 carry = 0;
-			for (int i = limb_shift; i < new_size; ++i)
+			UInt r;
+			sub(r, a, b);
+			return r;
+		}
+		friend constexpr UInt operator*(const UInt &a, const UInt &b) { return mul_low(a, b); }
+		constexpr UInt &operator+=(const UInt &b) { add(*this, *this, b); return *this; }
+		constexpr UInt &operator-=(const UInt &b) { sub(*this, *this, b); return *this; }
+		constexpr UInt &operator*=(const UInt &b) { return *this = mul_low(*this, b); }
+
+		friend constexpr UInt operator<<(const UInt &a, int s)
+		{
+			UInt r;
+			if (s >= Bits)
+				return r;
+			int q = s / 64, b = s % 64;
+#pragma GCC unroll 16
+			for (int i = N - 1; i >= q; i--)
 			{
-				u64 current = num->limbs[i];
-				num->limbs[i] = (current << bit_shift) | carry;
-				carry = current >> (64 - bit_shift);
+				u64 lo = i - q - 1 >= 0 && b ? a.limbs[i - q - 1] >> (64 - b) : 0;
+				r.limbs[i] = a.limbs[i - q] << b | lo;
 			}
-			if (carry)
+			return r;
+		}
+		friend constexpr UInt operator>>(const UInt &a, int s)
+		{
+			UInt r;
+			if (s >= Bits)
+				return r;
+			int q = s / 64, b = s % 64;
+#pragma GCC unroll 16
+			for (int i = 0; i < N - q; i++)
 			{
-				bigint_reserve(num, new_size + 1);
-				num->limbs[new_size++] = carry;
+				u64 hi = i + q + 1 < N && b ? a.limbs[i + q + 1] << (64 - b) : 0;
+				r.limbs[i] = a.limbs[i + q] >> b | hi;
 			}
+			return r;
 		}
-		num->size = new_size;
-		while (num->size > 1 && num->limbs[num->size - 1] == 0)
-			num->size--;
-	}
+		constexpr UInt &operator<<=(int s) { return *this = *this << s; }
+		constexpr UInt &operator>>=(int s) { return *this = *this >> s; }
 
-	// ---------- Divide by u64 ----------
-	void bigint_divide_u64(const BigInt *input, u64 divisor, BigInt *quotient, u64 *remainder)
-	{
-		if (divisor == 0)
+		friend constexpr UInt operator&(const UInt &a, const UInt &b)
 		{
-			fprintf(stderr, "Error: division by zero in bigint_divide_u64\n");
-			exit(EXIT_FAILURE);
+			UInt r;
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+				r.limbs[i] = a.limbs[i] & b.limbs[i];
+			return r;
 		}
-	
-		// Fast path: divisor is 1
-		if (divisor == 1)
+		friend constexpr UInt operator|(const UInt &a, const UInt &b)
 		{
-			bigint_copy(quotient, input);
-			*remainder = 0;
-			return;
+			UInt r;
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+				r.limbs[i] = a.limbs[i] | b.limbs[i];
+			return r;
 		}
-	
-		// Early exit for small input
-		if (input->size == 1)
+		friend constexpr UInt operator^(const UInt &a, const UInt &b)
 		{
-			bigint_reserve(quotient, 1);
-			quotient->limbs[0] = input->limbs[0] / divisor;
-			*remainder = input->limbs[0] % divisor;
-			quotient->size = (quotient->limbs[0] != 0) ? 1 : 0;
-			quotient->sign = input->sign;
-			return;
+			UInt r;
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+				r.limbs[i] = a.limbs[i] ^ b.limbs[i];
+			return r;
 		}
-	
-		// 🛠️ Allocate quotient limbs BEFORE use!
-		bigint_reserve(quotient, input->size);
-		memset(quotient->limbs, 0, sizeof(u64) * input->size);
-		quotient->size = input->size;
-		quotient->sign = input->sign;
-	
-		u64 rem = 0;
-		int new_size = 0;
-	
-		for (int i = input->size - 1; i >= 0; i--)
+		friend constexpr UInt operator~(const UInt &a)
 		{
-			__uint128_t dividend = ((__uint128_t)rem << 64) | input->limbs[i];
-			quotient->limbs[i] = dividend / divisor;
-			rem = dividend % divisor;
-	
-			if (quotient->limbs[i] != 0 && new_size == 0)
-				new_size = i + 1;
+			UInt r;
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+				r.limbs[i] = ~a.limbs[i];
+			return r;
 		}
-	
-		quotient->size = (new_size == 0) ? 1 : new_size;
-		*remainder = rem;
-	}
-	
 
-	// ---------- From String ----------
-	void bigint_from_string(BigInt *num, const char *str)
-	{
-		while (*str == ' ')
-			str++;
+		friend constexpr bool operator==(const UInt &a, const UInt &b) { return cmp(a, b) == 0; }
+		friend constexpr bool operator!=(const UInt &a, const UInt &b) { return cmp(a, b) != 0; }
+		friend constexpr bool operator<(const UInt &a, const UInt &b) { return cmp(a, b) < 0; }
+		friend constexpr bool operator<=(const UInt &a, const UInt &b) { return cmp(a, b) <= 0; }
+		friend constexpr bool operator>(const UInt &a, const UInt &b) { return cmp(a, b) > 0; }
+		friend constexpr bool operator>=(const UInt &a, const UInt &b) { return cmp(a, b) >= 0; }
 
-		int sign = 1;
-		if (*str == '-')
+		friend ostream &operator<<(ostream &out, const UInt &a)
 		{
-			sign = -1;
-			++str;
+			return out << BigInt(a);
 		}
-		while (*str == ' ')
-			str++;
-
-		bigint_init(num, 0);
-		size_t len = strlen(str);
-		size_t start = (len % CHUNK_DIGITS == 0) ? CHUNK_DIGITS : len % CHUNK_DIGITS;
+	};
 
-		char chunk_str[CHUNK_DIGITS + 1] = {0};
-		u64 chunk;
+	// Montgomery arithmetic modulo an odd Bits-bit modulus N with R = 2^Bits.
+	// Values in Montgomery form are a*R mod N; mul() is one CIOS pass (each
+	// multiply row is followed by its reduction row, in N + 2 limbs of
+	// temporary) and ends in a masked subtraction, so it does not branch on
+	// the operands. Inputs to mul() may be any UInt: the result is < N as long
+	// as one of them is.
+	template <int Bits>
+	struct UMont
+	{
+		typedef CBigInt::u64 u64;
+		typedef UInt<Bits> Int;
+		static constexpr int N = Int::N;
 
-		if (start > 0)
-		{
-			memcpy(chunk_str, str, start);
-			chunk_str[start] = '\0';
-			chunk = strtoull(chunk_str, NULL, 10);
-			bigint_add_u64(num, chunk, num);
-		}
+		Int modulus;
+		Int one; // R mod N
+		Int r2;	 // R^2 mod N
+		u64 ninv = 0;
 
-		for (size_t i = start; i < len; i += CHUNK_DIGITS)
+		constexpr explicit UMont(const Int &m) : modulus(m)
 		{
-			bigint_multiply_u64(num, CHUNK_BASE, num);
-			memcpy(chunk_str, str + i, CHUNK_DIGITS);
-			chunk_str[CHUNK_DIGITS] = '\0';
-			chunk = strtoull(chunk_str, NULL, 10);
-			bigint_add_u64(num, chunk, num);
+			if (!(m.limbs[0] & 1))
+				throw("Error: Montgomery modulus must be odd");
+			// Newton's iteration doubles the correct low bits from 3: 3, 6, ..., 96
+			u64 inv = m.limbs[0];
+			for (int i = 0; i < 5; i++)
+				inv *= 2 - m.limbs[0] * inv;
+			ninv = 0 - inv;
+			// R mod N and R^2 mod N by modular doubling from 1
+			Int x(m == Int(1) ? 0 : 1);
+			for (int i = 0; i < 2 * Bits; i++)
+			{
+				u64 carry = Int::add(x, x, x);
+				if (carry || x >= m)
+					x -= m;
+				if (i == Bits - 1)
+					one = x;
+			}
+			r2 = x;
 		}
 
-		num->sign = sign;
-	}
-	char *to_string(const BigInt *num)
-	{
-		if (num->size == 0 || (num->size == 1 && num->limbs[0] == 0))
-			return strdup("0");
-
-		// Estimate number of digits: log10(2) ≈ 0.30103
-		int max_digits = (int)(num->size * 64 * 0.30103) + 2;
-		char *buffer = (char *)malloc(max_digits);
-		if (!buffer)
+		// The run-time path for wide moduli: schoolbook product, then REDC
+		Int mul_kernels(const Int &a, const Int &b) const
 		{
-			fprintf(stderr, "Failed to allocate buffer for BigInt string\n");
-			exit(EXIT_FAILURE);
+			Int r;
+			u64 t[2 * N];
+			CBigInt::mul_basecase(t, a.limbs.data(), N, b.limbs.data(), N);
+			CBigInt::mont_redc(r.limbs.data(), t, modulus.limbs.data(), N, ninv);
+			return r;
 		}
 
-		int index = 0;
-		BigInt temp, quotient;
-		bigint_init(&temp, 0);
-		bigint_init(&quotient, 0);  // 👈 this ensures limbs = NULL, capacity = 0
-		bigint_copy(&temp, num);
-
-		u64 rem;
-		while (!(temp.size == 1 && temp.limbs[0] == 0))
+		// a * b / R mod N
+		constexpr Int mul(const Int &a, const Int &b) const
 		{
-			bigint_reserve(&quotient, temp.size);
-			bigint_divide_u64(&temp, 10, &quotient, &rem);
-			if (index >= max_digits - 1)
+			if (Int::kernels())
+				return mul_kernels(a, b);
+			Int r;
+			u64 t[N + 2] = {};
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
 			{
-				max_digits *= 2;
-				buffer = (char *)realloc(buffer, max_digits);
-				if (!buffer)
+				u64 carry = 0;
+#pragma GCC unroll 16
+				for (int j = 0; j < N; j++)
 				{
-					fprintf(stderr, "Realloc failed in to_string\n");
-					exit(EXIT_FAILURE);
+					unsigned __int128 p = (unsigned __int128)a.limbs[j] * b.limbs[i] + t[j] + carry;
+					t[j] = (u64)p;
+					carry = (u64)(p >> 64);
 				}
+				unsigned __int128 s = (unsigned __int128)t[N] + carry;
+				t[N] = (u64)s;
+				t[N + 1] = (u64)(s >> 64);
+				// add q*N with t + q*N = 0 mod 2^64 and shift down one limb
+				u64 q = t[0] * ninv;
+				unsigned __int128 p = (unsigned __int128)q * modulus.limbs[0] + t[0];
+				carry = (u64)(p >> 64);
+#pragma GCC unroll 16
+				for (int j = 1; j < N; j++)
+				{
+					p = (unsigned __int128)q * modulus.limbs[j] + t[j] + carry;
+					t[j - 1] = (u64)p;
+					carry = (u64)(p >> 64);
+				}
+				s = (unsigned __int128)t[N] + carry;
+				t[N - 1] = (u64)s;
+				t[N] = t[N + 1] + (u64)(s >> 64);
 			}
-			buffer[index++] = '0' + rem;
-			bigint_copy(&temp, &quotient);
+			// t < 2N: keep t only when t - N borrows out of the top limb
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+				r.limbs[i] = t[i];
+			Int d;
+			u64 borrow = Int::sub(d, r, modulus);
+			u64 keep = 0 - (borrow & (t[N] ^ 1));
+#pragma GCC unroll 16
+			for (int i = 0; i < N; i++)
+				r.limbs[i] = (r.limbs[i] & keep) | (d.limbs[i] & ~keep);
+			return r;
 		}
 
-		if (num->sign < 0)
+		constexpr Int to_mont(const Int &a) const { return mul(a, r2); }
+		constexpr Int from_mont(const Int &a) const { return mul(a, Int(1)); }
+
+		// a * b mod N
+		constexpr Int mulmod(const Int &a, const Int &b) const
 		{
-			buffer[index++] = '-';
+			return mul(mul(a, r2), b);
 		}
 
-		// Reverse the digits
-		for (int i = 0; i < index / 2; ++i)
+		// a^e mod N, square and multiply over the bits of e
+		constexpr Int powmod(const Int &a, const Int &e) const
 		{
-			char tmp = buffer[i];
-			buffer[i] = buffer[index - i - 1];
-			buffer[index - i - 1] = tmp;
+			Int x = to_mont(a), r = one;
+			for (int i = e.bit_length() - 1; i >= 0; i--)
+			{
+				r = mul(r, r);
+				if (e.test_bit(i))
+					r = mul(r, x);
+			}
+			return from_mont(r);
 		}
+	};
 
-		buffer[index] = '\0';
-
-		bigint_free(&temp);
-		bigint_free(&quotient);
-
-		return buffer; // Caller must free()
-	}
-
-	void bigint_print(const BigInt *num)
-	{
-		char *str = to_string(num);
-		printf("%s", str);
-		free(str);
-	}
 }
 
 #include <sstream>
@@ -1008,9 +6400,19 @@ bool testC(std::string s1, std::string s2)
 	CBigInt::bigint_init(&sumC, 0);
 	CBigInt::bigint_init(&prodC, 0);
 
-	// Calculate addition and multiplication
+	// Calculate addition, multiplication and division
 	CBigInt::bigint_add(&aC, &bC, &sumC);
 	CBigInt::bigint_multiply(&aC, &bC, &prodC);
+	CBigInt::BigInt quoC, remC;
+	CBigInt::bigint_init(&quoC, 0);
+	CBigInt::bigint_init(&remC, 0);
+	CBigInt::bigint_divide(&aC, &bC, &quoC, &remC);
+	CBigInt::BigInt sqrC;
+	CBigInt::bigint_init(&sqrC, 0);
+	CBigInt::bigint_square(&aC, &sqrC);
+	CBigInt::BigInt gcdC;
+	CBigInt::bigint_init(&gcdC, 0);
+	CBigInt::bigint_gcd(&aC, &bC, &gcdC);
 
 	// Convert CBigInt to GMP (mpz_t)
 	mpz_t sumC_GMP, prodC_GMP;
@@ -1027,6 +6429,27 @@ bool testC(std::string s1, std::string s2)
 	mpz_set_str(prodC_GMP, prodC_str, 10);
 	free(prodC_str);
 
+	// Convert quoC and remC to GMP
+	mpz_t quoC_GMP, remC_GMP;
+	mpz_init(quoC_GMP);
+	mpz_init(remC_GMP);
+	char *quoC_str = CBigInt::to_string(&quoC);
+	mpz_set_str(quoC_GMP, quoC_str, 10);
+	free(quoC_str);
+	char *remC_str = CBigInt::to_string(&remC);
+	mpz_set_str(remC_GMP, remC_str, 10);
+	free(remC_str);
+	mpz_t sqrC_GMP;
+	mpz_init(sqrC_GMP);
+	char *sqrC_str = CBigInt::to_string(&sqrC);
+	mpz_set_str(sqrC_GMP, sqrC_str, 10);
+	free(sqrC_str);
+	mpz_t gcdC_GMP;
+	mpz_init(gcdC_GMP);
+	char *gcdC_str = CBigInt::to_string(&gcdC);
+	mpz_set_str(gcdC_GMP, gcdC_str, 10);
+	free(gcdC_str);
+
 	// ---------- Using GMP for Validation ----------
 	mpz_t aGMP, bGMP, sumGMP, prodGMP;
 	mpz_init(aGMP);
@@ -1045,9 +6468,19 @@ bool testC(std::string s1, std::string s2)
 		return false;
 	}
 
-	// Perform GMP addition and multiplication
+	// Perform GMP addition, multiplication and division
+	mpz_t quoGMP, remGMP;
+	mpz_init(quoGMP);
+	mpz_init(remGMP);
 	mpz_add(sumGMP, aGMP, bGMP);
 	mpz_mul(prodGMP, aGMP, bGMP);
+	mpz_tdiv_qr(quoGMP, remGMP, aGMP, bGMP);
+	mpz_t sqrGMP;
+	mpz_init(sqrGMP);
+	mpz_mul(sqrGMP, aGMP, aGMP);
+	mpz_t gcdGMP;
+	mpz_init(gcdGMP);
+	mpz_gcd(gcdGMP, aGMP, bGMP);
 
 	// ---------- Validation ----------
 	bool valid = true;
@@ -1063,14 +6496,557 @@ bool testC(std::string s1, std::string s2)
 		std::cerr << "Validation failed: GMP product does not match CBigInt product!" << prodC_str << "\n";
 		valid = false;
 	}
+	// Compare GMP quotient and remainder with CBigInt division
+	if (mpz_cmp(quoGMP, quoC_GMP) != 0 || mpz_cmp(remGMP, remC_GMP) != 0)
+	{
+		std::cerr << "Validation failed: GMP division does not match CBigInt division!\n";
+		valid = false;
+	}
+	// Compare GMP square with CBigInt square
+	if (mpz_cmp(sqrGMP, sqrC_GMP) != 0)
+	{
+		std::cerr << "Validation failed: GMP square does not match CBigInt square!\n";
+		valid = false;
+	}
+	// Compare GMP quotients and remainders with CBigInt's for a^2 / b and
+	// ab / (a + 1). On the larger pair both quotient and divisor pass
+	// DIV_NEWTON_THRESHOLD, the first quotient longer than the divisor and
+	// the second shorter.
+	CBigInt::BigInt oneC, divisorC, longQuoC, longRemC;
+	CBigInt::bigint_init(&oneC, 1);
+	CBigInt::bigint_init(&divisorC, 0);
+	CBigInt::bigint_init(&longQuoC, 0);
+	CBigInt::bigint_init(&longRemC, 0);
+	CBigInt::bigint_add(&aC, &oneC, &divisorC);
+	mpz_t longDivisorGMP, longQuoGMP, longRemGMP, longQuoC_GMP, longRemC_GMP;
+	mpz_init(longDivisorGMP);
+	mpz_init(longQuoGMP);
+	mpz_init(longRemGMP);
+	mpz_init(longQuoC_GMP);
+	mpz_init(longRemC_GMP);
+	for (int i = 0; i < 2; i++)
+	{
+		if (i == 0)
+		{
+			CBigInt::bigint_divide(&sqrC, &bC, &longQuoC, &longRemC);
+			mpz_tdiv_qr(longQuoGMP, longRemGMP, sqrGMP, bGMP);
+		}
+		else
+		{
+			CBigInt::bigint_divide(&prodC, &divisorC, &longQuoC, &longRemC);
+			mpz_add_ui(longDivisorGMP, aGMP, 1);
+			mpz_tdiv_qr(longQuoGMP, longRemGMP, prodGMP, longDivisorGMP);
+		}
+		char *longQuoC_str = CBigInt::to_string(&longQuoC);
+		char *longRemC_str = CBigInt::to_string(&longRemC);
+		mpz_set_str(longQuoC_GMP, longQuoC_str, 10);
+		mpz_set_str(longRemC_GMP, longRemC_str, 10);
+		free(longQuoC_str);
+		free(longRemC_str);
+		if (mpz_cmp(longQuoGMP, longQuoC_GMP) != 0 || mpz_cmp(longRemGMP, longRemC_GMP) != 0)
+		{
+			std::cerr << "Validation failed: GMP long division does not match CBigInt division!\n";
+			valid = false;
+		}
+	}
+	CBigInt::bigint_free(&oneC);
+	CBigInt::bigint_free(&divisorC);
+	CBigInt::bigint_free(&longQuoC);
+	CBigInt::bigint_free(&longRemC);
+	mpz_clear(longDivisorGMP);
+	mpz_clear(longQuoGMP);
+	mpz_clear(longRemGMP);
+	mpz_clear(longQuoC_GMP);
+	mpz_clear(longRemC_GMP);
+	// Compare GMP gcd with CBigInt gcd
+	if (mpz_cmp(gcdGMP, gcdC_GMP) != 0)
+	{
+		std::cerr << "Validation failed: GMP gcd does not match CBigInt gcd!\n";
+		valid = false;
+	}
+	// Compare GMP gcd with CBigInt gcdext for (a, b), and for (ab, a^2) whose
+	// gcd is a multiple of a; both pass GCD_HGCD_THRESHOLD on the larger
+	// pair. The cofactors must give s x + t y = g with |s| < |y| / g.
+	CBigInt::BigInt extG, extS, extT, extCheck, extBound;
+	CBigInt::bigint_init(&extG, 0);
+	CBigInt::bigint_init(&extS, 0);
+	CBigInt::bigint_init(&extT, 0);
+	CBigInt::bigint_init(&extCheck, 0);
+	CBigInt::bigint_init(&extBound, 0);
+	mpz_t extGMP, extC_GMP;
+	mpz_init(extGMP);
+	mpz_init(extC_GMP);
+	for (int i = 0; i < 2; i++)
+	{
+		const CBigInt::BigInt *x = i ? &prodC : &aC, *y = i ? &sqrC : &bC;
+		CBigInt::bigint_gcdext(x, y, &extG, &extS, &extT);
+		mpz_gcd(extGMP, i ? prodGMP : aGMP, i ? sqrGMP : bGMP);
+		char *extG_str = CBigInt::to_string(&extG);
+		mpz_set_str(extC_GMP, extG_str, 10);
+		free(extG_str);
+		// s x + t y - g must be zero
+		CBigInt::bigint_multiply(&extS, x, &extCheck);
+		CBigInt::bigint_multiply(&extT, y, &extBound);
+		CBigInt::bigint_add(&extCheck, &extBound, &extCheck);
+		CBigInt::bigint_subtract(&extCheck, &extG, &extCheck);
+		CBigInt::bigint_divide(y, &extG, &extBound, NULL);
+		extS.sign = 1;
+		if (mpz_cmp(extGMP, extC_GMP) != 0 || !CBigInt::bigint_is_zero(&extCheck) ||
+			CBigInt::bigint_compare(&extS, &extBound) >= 0)
+		{
+			std::cerr << "Validation failed: GMP gcd does not match CBigInt gcdext, or s x + t y != g!\n";
+			valid = false;
+		}
+	}
+	// Compare GMP inverses with CBigInt's: a mod b, which need not exist,
+	// and b mod ab + 1, which always does
+	for (int i = 0; i < 2; i++)
+	{
+		mpz_t invModGMP, invGMP;
+		mpz_init(invModGMP);
+		mpz_init(invGMP);
+		CBigInt::BigInt invModC, invC;
+		CBigInt::bigint_init(&invModC, 0);
+		CBigInt::bigint_init(&invC, 0);
+		const CBigInt::BigInt *x = i ? &bC : &aC;
+		if (i)
+		{
+			CBigInt::BigInt oneC;
+			CBigInt::bigint_init(&oneC, 1);
+			CBigInt::bigint_add(&prodC, &oneC, &invModC);
+			CBigInt::bigint_free(&oneC);
+			mpz_add_ui(invModGMP, prodGMP, 1);
+		}
+		else
+		{
+			CBigInt::bigint_copy(&invModC, &bC);
+			mpz_set(invModGMP, bGMP);
+		}
+		int invOk = CBigInt::bigint_invert(x, &invModC, &invC);
+		int invOkGMP = mpz_invert(invGMP, i ? bGMP : aGMP, invModGMP) != 0;
+		char *inv_str = CBigInt::to_string(&invC);
+		mpz_set_str(extC_GMP, inv_str, 10);
+		free(inv_str);
+		if (invOk != invOkGMP || (invOk && mpz_cmp(invGMP, extC_GMP) != 0) || (i && !invOk))
+		{
+			std::cerr << "Validation failed: GMP invert does not match CBigInt invert!\n";
+			valid = false;
+		}
+		CBigInt::bigint_free(&invModC);
+		CBigInt::bigint_free(&invC);
+		mpz_clear(invModGMP);
+		mpz_clear(invGMP);
+	}
+	CBigInt::bigint_free(&extG);
+	CBigInt::bigint_free(&extS);
+	CBigInt::bigint_free(&extT);
+	CBigInt::bigint_free(&extCheck);
+	CBigInt::bigint_free(&extBound);
+	mpz_clear(extGMP);
+	mpz_clear(extC_GMP);
+	// Compare GMP products and squares with CBigInt's on four threads: ab,
+	// which on the larger pair splits its NTT passes, and 1800 limbs cut from
+	// (ab * a^2)^2, whose Toom-3 sub-products are large enough to split again
+	int savedThreads = CBigInt::bigint_get_threads();
+	CBigInt::bigint_set_threads(4);
+	CBigInt::BigInt thrProdC, thrC, thrSqrC, thrNextC, thrMulC, thrOneC;
+	CBigInt::bigint_init(&thrProdC, 0);
+	CBigInt::bigint_init(&thrC, 0);
+	CBigInt::bigint_init(&thrSqrC, 0);
+	CBigInt::bigint_init(&thrNextC, 0);
+	CBigInt::bigint_init(&thrMulC, 0);
+	CBigInt::bigint_init(&thrOneC, 1);
+	CBigInt::bigint_multiply(&aC, &bC, &thrProdC);
+	CBigInt::bigint_multiply(&prodC, &sqrC, &thrC);
+	CBigInt::bigint_square(&thrC, &thrSqrC);
+	int thrCut = 64 * (thrSqrC.size - 1800);
+	CBigInt::bigint_copy(&thrC, &thrSqrC);
+	CBigInt::bigint_shift_right(&thrC, thrCut);
+	CBigInt::bigint_square(&thrC, &thrSqrC);
+	CBigInt::bigint_add(&thrC, &thrOneC, &thrNextC);
+	CBigInt::bigint_multiply(&thrC, &thrNextC, &thrMulC);
+	mpz_t thrGMP, thrSqrGMP, thrNextGMP, thrC_GMP;
+	mpz_init(thrGMP);
+	mpz_init(thrSqrGMP);
+	mpz_init(thrNextGMP);
+	mpz_init(thrC_GMP);
+	mpz_mul(thrGMP, prodGMP, sqrGMP);
+	mpz_mul(thrGMP, thrGMP, thrGMP);
+	mpz_fdiv_q_2exp(thrGMP, thrGMP, thrCut);
+	mpz_mul(thrSqrGMP, thrGMP, thrGMP);
+	mpz_add_ui(thrNextGMP, thrGMP, 1);
+	mpz_mul(thrNextGMP, thrNextGMP, thrGMP);
+	char *thr_str = CBigInt::to_string(&thrProdC);
+	mpz_set_str(thrC_GMP, thr_str, 10);
+	free(thr_str);
+	bool thrValid = mpz_cmp(thrC_GMP, prodGMP) == 0;
+	thr_str = CBigInt::to_string(&thrSqrC);
+	mpz_set_str(thrC_GMP, thr_str, 10);
+	free(thr_str);
+	thrValid = thrValid && mpz_cmp(thrC_GMP, thrSqrGMP) == 0;
+	thr_str = CBigInt::to_string(&thrMulC);
+	mpz_set_str(thrC_GMP, thr_str, 10);
+	free(thr_str);
+	thrValid = thrValid && mpz_cmp(thrC_GMP, thrNextGMP) == 0;
+	if (!thrValid)
+	{
+		std::cerr << "Validation failed: GMP product/square does not match CBigInt's on four threads!\n";
+		valid = false;
+	}
+	CBigInt::bigint_set_threads(savedThreads);
+	CBigInt::bigint_free(&thrProdC);
+	CBigInt::bigint_free(&thrC);
+	CBigInt::bigint_free(&thrSqrC);
+	CBigInt::bigint_free(&thrNextC);
+	CBigInt::bigint_free(&thrMulC);
+	CBigInt::bigint_free(&thrOneC);
+	mpz_clear(thrGMP);
+	mpz_clear(thrSqrGMP);
+	mpz_clear(thrNextGMP);
+	mpz_clear(thrC_GMP);
+	// Compare GMP ab mod m and (a + b) mod m with the Barrett context's, for
+	// m = a + 1 (past BARRETT_THRESHOLD) and the top 1900 digits of a (below)
+	mpz_t barModGMP, barGMP, barC_GMP;
+	mpz_init(barModGMP);
+	mpz_init(barGMP);
+	mpz_init(barC_GMP);
+	for (int i = 0; i < 2; i++)
+	{
+		CBigInt::BigInt barModC, barC, oneC;
+		CBigInt::bigint_init(&barC, 0);
+		if (i)
+			CBigInt::bigint_from_string(&barModC, s1.substr(0, 1900).c_str());
+		else
+		{
+			CBigInt::bigint_init(&oneC, 1);
+			CBigInt::bigint_init(&barModC, 0);
+			CBigInt::bigint_add(&aC, &oneC, &barModC);
+			CBigInt::bigint_free(&oneC);
+		}
+		char *bar_str = CBigInt::to_string(&barModC);
+		mpz_set_str(barModGMP, bar_str, 10);
+		free(bar_str);
+		CBigInt::BigIntBarrett barCtx;
+		CBigInt::bigint_barrett_init(&barCtx, &barModC);
+		for (int op = 0; op < 2; op++)
+		{
+			if (op)
+			{
+				CBigInt::bigint_barrett_addmod(&barCtx, &aC, &bC, &barC);
+				mpz_add(barGMP, aGMP, bGMP);
+			}
+			else
+			{
+				CBigInt::bigint_barrett_mulmod(&barCtx, &aC, &bC, &barC);
+				mpz_set(barGMP, prodGMP);
+			}
+			mpz_mod(barGMP, barGMP, barModGMP);
+			bar_str = CBigInt::to_string(&barC);
+			mpz_set_str(barC_GMP, bar_str, 10);
+			free(bar_str);
+			if (mpz_cmp(barGMP, barC_GMP) != 0)
+			{
+				std::cerr << "Validation failed: GMP " << (op ? "addmod" : "mulmod") << " does not match CBigInt Barrett " << (op ? "addmod" : "mulmod") << "!\n";
+				valid = false;
+			}
+		}
+		CBigInt::bigint_barrett_free(&barCtx);
+		CBigInt::bigint_free(&barModC);
+		CBigInt::bigint_free(&barC);
+	}
+	mpz_clear(barModGMP);
+	mpz_clear(barGMP);
+	mpz_clear(barC_GMP);
+	// A one-number batch goes through the lane-parallel kernels
+	CBigInt::BigIntBatch aB, bB, prodB;
+	CBigInt::bigint_batch_init(&aB, 1, aC.size);
+	CBigInt::bigint_batch_init(&bB, 1, bC.size);
+	CBigInt::bigint_batch_init(&prodB, 1, aC.size + bC.size);
+	CBigInt::bigint_batch_set(&aB, 0, &aC);
+	CBigInt::bigint_batch_set(&bB, 0, &bC);
+	CBigInt::bigint_batch_multiply(&aB, &bB, &prodB);
+	CBigInt::BigInt batchC;
+	CBigInt::bigint_init(&batchC, 0);
+	CBigInt::bigint_batch_get(&prodB, 0, &batchC);
+	if (CBigInt::bigint_compare(&batchC, &prodC) != 0)
+	{
+		std::cerr << "Validation failed: batched product does not match CBigInt product!\n";
+		valid = false;
+	}
+	CBigInt::bigint_batch_free(&aB);
+	CBigInt::bigint_batch_free(&bB);
+	CBigInt::bigint_batch_free(&prodB);
+	// All-ones operands 4000 limbs wide fill every column of the batched
+	// product to its maximum
+	const int wide = 4000;
+	CBigInt::BigInt onesC, onesProdC;
+	CBigInt::bigint_init(&onesC, 0);
+	CBigInt::bigint_init(&onesProdC, 0);
+	CBigInt::bigint_reserve(&onesC, wide);
+	memset(onesC.limbs, 0xff, wide * sizeof(CBigInt::u64));
+	onesC.size = wide;
+	onesC.sign = 1;
+	CBigInt::bigint_multiply(&onesC, &onesC, &onesProdC);
+	CBigInt::bigint_batch_init(&aB, 1, wide);
+	CBigInt::bigint_batch_init(&prodB, 1, 2 * wide);
+	CBigInt::bigint_batch_set(&aB, 0, &onesC);
+	CBigInt::bigint_batch_multiply(&aB, &aB, &prodB);
+	CBigInt::bigint_batch_get(&prodB, 0, &batchC);
+	if (CBigInt::bigint_compare(&batchC, &onesProdC) != 0)
+	{
+		std::cerr << "Validation failed: wide batched product does not match CBigInt product!\n";
+		valid = false;
+	}
+	CBigInt::bigint_free(&onesC);
+	CBigInt::bigint_free(&onesProdC);
+	CBigInt::bigint_free(&batchC);
+	CBigInt::bigint_batch_free(&aB);
+	CBigInt::bigint_batch_free(&prodB);
+	// Compare GMP xor with CBigInt xor
+	CBigInt::BigInt xorC;
+	CBigInt::bigint_init(&xorC, 0);
+	CBigInt::bigint_xor(&aC, &bC, &xorC);
+	char *xorC_str = CBigInt::to_string(&xorC);
+	mpz_t xorC_GMP, xorGMP;
+	mpz_init_set_str(xorC_GMP, xorC_str, 10);
+	free(xorC_str);
+	mpz_init(xorGMP);
+	mpz_xor(xorGMP, aGMP, bGMP);
+	if (mpz_cmp(xorGMP, xorC_GMP) != 0)
+	{
+		std::cerr << "Validation failed: GMP xor does not match CBigInt xor!\n";
+		valid = false;
+	}
+	CBigInt::bigint_free(&xorC);
+	mpz_clear(xorC_GMP);
+	mpz_clear(xorGMP);
+	// Compare GMP hex output with CBigInt hex output, and parse it back
+	char *hexC_str = CBigInt::bigint_to_string_base(&prodC, 16);
+	char *hexGMP_str = mpz_get_str(NULL, 16, prodGMP);
+	CBigInt::BigInt hexC;
+	CBigInt::bigint_from_string_base(&hexC, hexGMP_str, 16);
+	if (strcmp(hexC_str, hexGMP_str) != 0 || CBigInt::bigint_compare(&hexC, &prodC) != 0)
+	{
+		std::cerr << "Validation failed: GMP hex does not match CBigInt hex!\n";
+		valid = false;
+	}
+	CBigInt::bigint_free(&hexC);
+	free(hexC_str);
+	free(hexGMP_str);
+	// A digit outside the base fails the parse in base 10 as in base 16
+	CBigInt::BigInt badC;
+	if (CBigInt::bigint_from_string_base(&badC, "12x4", 10) != 0 || !CBigInt::bigint_is_zero(&badC))
+	{
+		std::cerr << "Validation failed: CBigInt parsed \"12x4\" in base 10!\n";
+		valid = false;
+	}
+	CBigInt::bigint_free(&badC);
+	if (CBigInt::bigint_from_string_base(&badC, "12x4", 16) != 0 || !CBigInt::bigint_is_zero(&badC))
+	{
+		std::cerr << "Validation failed: CBigInt parsed \"12x4\" in base 16!\n";
+		valid = false;
+	}
+	CBigInt::bigint_free(&badC);
+	// Compare GMP 2ab + 3a with the carry-save accumulator's
+	CBigInt::BigInt pairC[2], accC;
+	CBigInt::bigint_init(&pairC[0], 0);
+	CBigInt::bigint_init(&pairC[1], 0);
+	CBigInt::bigint_init(&accC, 0);
+	CBigInt::bigint_copy(&pairC[0], &bC);
+	CBigInt::bigint_copy(&pairC[1], &aC);
+	CBigInt::BigIntAcc acc;
+	CBigInt::bigint_acc_init(&acc);
+	CBigInt::bigint_acc_dot(&acc, pairC, pairC + 1, 1);
+	CBigInt::bigint_acc_dot(&acc, pairC + 1, pairC, 1);
+	CBigInt::bigint_acc_addmul_small(&acc, &aC, 3);
+	CBigInt::bigint_acc_result(&acc, &accC);
+	char *accC_str = CBigInt::to_string(&accC);
+	mpz_t accC_GMP, accGMP;
+	mpz_init_set_str(accC_GMP, accC_str, 10);
+	free(accC_str);
+	mpz_init(accGMP);
+	mpz_mul_ui(accGMP, aGMP, 3);
+	mpz_addmul_ui(accGMP, prodGMP, 2);
+	if (mpz_cmp(accGMP, accC_GMP) != 0)
+	{
+		std::cerr << "Validation failed: GMP dot product does not match CBigInt accumulator!\n";
+		valid = false;
+	}
+	CBigInt::bigint_acc_free(&acc);
+	CBigInt::bigint_free(&pairC[0]);
+	CBigInt::bigint_free(&pairC[1]);
+	CBigInt::bigint_free(&accC);
+	mpz_clear(accC_GMP);
+	mpz_clear(accGMP);
+#if BIGINT_HAVE_MMAP
+	// Compare the out-of-core product, through temporary limb files, with the in-memory one
+	char aPath[] = "/tmp/bigintXXXXXX", bPath[] = "/tmp/bigintXXXXXX", prodPath[] = "/tmp/bigintXXXXXX";
+	close(mkstemp(aPath));
+	close(mkstemp(bPath));
+	close(mkstemp(prodPath));
+	CBigInt::BigInt diskC;
+	CBigInt::bigint_init(&diskC, 0);
+	if (CBigInt::bigint_file_save(aPath, &aC) < 0 || CBigInt::bigint_file_save(bPath, &bC) < 0 ||
+		CBigInt::bigint_multiply_files(aPath, bPath, prodPath, 0, NULL) < 0 || CBigInt::bigint_file_load(prodPath, &diskC) < 0 ||
+		CBigInt::bigint_compare(&diskC, &prodC) != 0)
+	{
+		std::cerr << "Validation failed: out-of-core product does not match CBigInt product!\n";
+		valid = false;
+	}
+	CBigInt::bigint_free(&diskC);
+	unlink(aPath);
+	unlink(bPath);
+	unlink(prodPath);
+#endif
+	// Compare GMP products and squares with CBigInt's after loading a tuning
+	// file whose NTT cutoffs sit below the Toom-3 ones
+	int savedTuning[CBigInt::TUNE_COUNT];
+	memcpy(savedTuning, CBigInt::tuning, sizeof(savedTuning));
+	const char *tunePath = "bigint_tuning_test.h";
+	FILE *tuneFile = fopen(tunePath, "w");
+	if (tuneFile)
+	{
+		fputs("#define TUNED_NTT_THRESHOLD 64\n#define TUNED_SQR_NTT_THRESHOLD 64\n", tuneFile);
+		fclose(tuneFile);
+	}
+	CBigInt::BigInt shortC, tunedProdC, tunedSqrC;
+	CBigInt::bigint_from_string(&shortC, s1.substr(0, 1900).c_str()); // about 100 limbs
+	CBigInt::bigint_init(&tunedProdC, 0);
+	CBigInt::bigint_init(&tunedSqrC, 0);
+	bool tuned = CBigInt::bigint_load_tuning(tunePath) == 2;
+	CBigInt::bigint_multiply(&aC, &bC, &tunedProdC);
+	CBigInt::bigint_square(&shortC, &tunedSqrC);
+	char *tunedSqrC_str = CBigInt::to_string(&tunedSqrC);
+	mpz_t tunedSqrC_GMP, tunedSqrGMP;
+	mpz_init_set_str(tunedSqrC_GMP, tunedSqrC_str, 10);
+	free(tunedSqrC_str);
+	mpz_init_set_str(tunedSqrGMP, s1.substr(0, 1900).c_str(), 10);
+	mpz_mul(tunedSqrGMP, tunedSqrGMP, tunedSqrGMP);
+	if (!tuned || CBigInt::bigint_compare(&tunedProdC, &prodC) != 0 || mpz_cmp(tunedSqrGMP, tunedSqrC_GMP) != 0)
+	{
+		std::cerr << "Validation failed: GMP product/square does not match CBigInt's under a mis-ordered tuning file!\n";
+		valid = false;
+	}
+	memcpy(CBigInt::tuning, savedTuning, sizeof(savedTuning));
+	remove(tunePath);
+	CBigInt::bigint_free(&shortC);
+	CBigInt::bigint_free(&tunedProdC);
+	CBigInt::bigint_free(&tunedSqrC);
+	mpz_clear(tunedSqrC_GMP);
+	mpz_clear(tunedSqrGMP);
+	// Compare GMP modular powers with CBigInt's through both entry points, for
+	// an odd modulus, that modulus times 2^70 and 2^128, and the powers of
+	// two 2^200 and 2^192, with a negative base and a zero exponent as well
+	mpz_t powBase[2], powExp[2], powMod[5], powGMP, powC_GMP;
+	mpz_init_set_str(powBase[0], s1.substr(0, 600).c_str(), 10);
+	mpz_init(powBase[1]);
+	mpz_neg(powBase[1], powBase[0]);
+	mpz_init_set_str(powExp[0], s2.substr(400, 300).c_str(), 10);
+	mpz_init_set_ui(powExp[1], 0);
+	mpz_init_set_str(powMod[0], s2.substr(0, 400).c_str(), 10);
+	mpz_setbit(powMod[0], 0);
+	mpz_init(powMod[1]);
+	mpz_mul_2exp(powMod[1], powMod[0], 70);
+	mpz_init(powMod[2]);
+	mpz_mul_2exp(powMod[2], powMod[0], 128);
+	mpz_init_set_ui(powMod[3], 0);
+	mpz_setbit(powMod[3], 200);
+	mpz_init_set_ui(powMod[4], 0);
+	mpz_setbit(powMod[4], 192);
+	mpz_init(powGMP);
+	mpz_init(powC_GMP);
+	CBigInt::BigInt powBaseC, powExpC, powModC, powC;
+	CBigInt::bigint_init(&powC, 0);
+	for (int m = 0; m < 5; m++)
+		for (int b = 0; b < 2; b++)
+			for (int e = 0; e < 2; e++)
+				for (int ct = 0; ct < 2; ct++)
+				{
+					char *str = mpz_get_str(NULL, 10, powBase[b]);
+					CBigInt::bigint_from_string(&powBaseC, str);
+					free(str);
+					str = mpz_get_str(NULL, 10, powExp[e]);
+					CBigInt::bigint_from_string(&powExpC, str);
+					free(str);
+					str = mpz_get_str(NULL, 10, powMod[m]);
+					CBigInt::bigint_from_string(&powModC, str);
+					free(str);
+					if (ct)
+						CBigInt::bigint_modexp_ct(&powBaseC, &powExpC, &powModC, &powC);
+					else
+						CBigInt::bigint_modexp(&powBaseC, &powExpC, &powModC, &powC);
+					str = CBigInt::to_string(&powC);
+					mpz_set_str(powC_GMP, str, 10);
+					free(str);
+					mpz_powm(powGMP, powBase[b], powExp[e], powMod[m]);
+					if (mpz_cmp(powGMP, powC_GMP) != 0)
+					{
+						std::cerr << "Validation failed: GMP powm does not match CBigInt " << (ct ? "modexp_ct" : "modexp")
+								  << " (modulus " << m << ", base " << b << ", exponent " << e << ")!\n";
+						valid = false;
+					}
+					CBigInt::bigint_free(&powBaseC);
+					CBigInt::bigint_free(&powExpC);
+					CBigInt::bigint_free(&powModC);
+				}
+	// The odd modulus again, through a Montgomery context of its own
+	char *powMod_str = mpz_get_str(NULL, 10, powMod[0]);
+	CBigInt::bigint_from_string(&powModC, powMod_str);
+	free(powMod_str);
+	char *powBase_str = mpz_get_str(NULL, 10, powBase[0]);
+	CBigInt::bigint_from_string(&powBaseC, powBase_str);
+	free(powBase_str);
+	char *powExp_str = mpz_get_str(NULL, 10, powExp[0]);
+	CBigInt::bigint_from_string(&powExpC, powExp_str);
+	free(powExp_str);
+	CBigInt::BigIntMont powCtx;
+	CBigInt::bigint_mont_init(&powCtx, &powModC);
+	mpz_powm(powGMP, powBase[0], powExp[0], powMod[0]);
+	for (int ct = 0; ct < 2; ct++)
+	{
+		if (ct)
+			CBigInt::bigint_mont_powm_ct(&powCtx, &powBaseC, &powExpC, &powC);
+		else
+			CBigInt::bigint_mont_powm(&powCtx, &powBaseC, &powExpC, &powC);
+		char *powC_str = CBigInt::to_string(&powC);
+		mpz_set_str(powC_GMP, powC_str, 10);
+		free(powC_str);
+		if (mpz_cmp(powGMP, powC_GMP) != 0)
+		{
+			std::cerr << "Validation failed: GMP powm does not match CBigInt " << (ct ? "mont_powm_ct" : "mont_powm") << "!\n";
+			valid = false;
+		}
+	}
+	CBigInt::bigint_mont_free(&powCtx);
+	CBigInt::bigint_free(&powBaseC);
+	CBigInt::bigint_free(&powExpC);
+	CBigInt::bigint_free(&powModC);
+	CBigInt::bigint_free(&powC);
+	for (int i = 0; i < 2; i++)
+	{
+		mpz_clear(powBase[i]);
+		mpz_clear(powExp[i]);
+	}
+	for (int i = 0; i < 5; i++)
+		mpz_clear(powMod[i]);
+	mpz_clear(powGMP);
+	mpz_clear(powC_GMP);
 
 	// Clean up GMP memory
 	mpz_clear(aGMP);
 	mpz_clear(bGMP);
 	mpz_clear(sumGMP);
 	mpz_clear(prodGMP);
+	mpz_clear(quoGMP);
+	mpz_clear(remGMP);
 	mpz_clear(sumC_GMP);
 	mpz_clear(prodC_GMP);
+	mpz_clear(quoC_GMP);
+	mpz_clear(remC_GMP);
+	mpz_clear(sqrGMP);
+	mpz_clear(sqrC_GMP);
+	mpz_clear(gcdGMP);
+	mpz_clear(gcdC_GMP);
 
 	return valid;
 }
@@ -1082,6 +7058,16 @@ bool testCPP(std::string s1, std::string s2)
 	CPPBigInt::BigInt aCPP(s1), bCPP(s2);
 	CPPBigInt::BigInt sumCPP = aCPP + bCPP;
 	CPPBigInt::BigInt prodCPP = aCPP * bCPP;
+	CPPBigInt::BigInt remCPP;
+	CPPBigInt::BigInt sqrtCPP = CPPBigInt::sqrtrem(aCPP, remCPP);
+	int n = s1.size();
+	CPPBigInt::BigInt factCPP = CPPBigInt::Factorial(n);
+	CPPBigInt::BigInt fibCPP = CPPBigInt::NthFibonacci(n);
+	CPPBigInt::BigInt catCPP = CPPBigInt::NthCatalan(n);
+	// 256-bit Montgomery product of the low halves, modulo an odd modulus
+	CPPBigInt::UInt<256> a256(aCPP), m256 = CPPBigInt::UInt<256>(bCPP) | CPPBigInt::UInt<256>(1);
+	CPPBigInt::UMont<256> mont(m256);
+	CPPBigInt::BigInt mulmodCPP(mont.mulmod(a256, a256));
 
 	mpz_t sumCPP_GMP, prodCPP_GMP;
 	mpz_init(sumCPP_GMP);
@@ -1097,6 +7083,15 @@ bool testCPP(std::string s1, std::string s2)
 	mpz_set_str(prodCPP_GMP, prodCPP_str, 10);
 	free(prodCPP_str);
 
+	// Convert sqrtCPP and remCPP to GMP
+	mpz_t sqrtCPP_GMP, remCPP_GMP;
+	mpz_init_set_str(sqrtCPP_GMP, to_string(sqrtCPP).c_str(), 10);
+	mpz_init_set_str(remCPP_GMP, to_string(remCPP).c_str(), 10);
+	mpz_t factCPP_GMP, fibCPP_GMP, catCPP_GMP;
+	mpz_init_set_str(factCPP_GMP, to_string(factCPP).c_str(), 10);
+	mpz_init_set_str(fibCPP_GMP, to_string(fibCPP).c_str(), 10);
+	mpz_init_set_str(catCPP_GMP, to_string(catCPP).c_str(), 10);
+
 	// ---------- Using GMP for Validation ----------
 	mpz_t aGMP, bGMP, sumGMP, prodGMP;
 	mpz_init(aGMP);
@@ -1115,9 +7110,30 @@ bool testCPP(std::string s1, std::string s2)
 		return false;
 	}
 
-	// Perform GMP addition and multiplication
+	// Perform GMP addition, multiplication and square root
 	mpz_add(sumGMP, aGMP, bGMP);
 	mpz_mul(prodGMP, aGMP, bGMP);
+	mpz_t sqrtGMP, remGMP;
+	mpz_init(sqrtGMP);
+	mpz_init(remGMP);
+	mpz_sqrtrem(sqrtGMP, remGMP, aGMP);
+	mpz_t factGMP, fibGMP, catGMP;
+	mpz_init(factGMP);
+	mpz_init(fibGMP);
+	mpz_init(catGMP);
+	mpz_fac_ui(factGMP, n);
+	mpz_fib_ui(fibGMP, n);
+	mpz_bin_uiui(catGMP, 2 * n, n);
+	mpz_divexact_ui(catGMP, catGMP, n + 1);
+	mpz_t aLow, mLow, mulmodGMP;
+	mpz_init(aLow);
+	mpz_init(mLow);
+	mpz_init_set_str(mulmodGMP, to_string(mulmodCPP).c_str(), 10);
+	mpz_fdiv_r_2exp(aLow, aGMP, 256);
+	mpz_fdiv_r_2exp(mLow, bGMP, 256);
+	mpz_setbit(mLow, 0);
+	mpz_mul(aLow, aLow, aLow);
+	mpz_mod(aLow, aLow, mLow);
 
 	// ---------- Validation ----------
 	bool valid = true;
@@ -1133,6 +7149,55 @@ bool testCPP(std::string s1, std::string s2)
 		std::cerr << "Validation failed: GMP product does not match CPPBigInt::BigInt product!" << std::endl;
 		valid = false;
 	}
+	// Compare GMP square root and remainder with CPPBigInt sqrtrem
+	if (mpz_cmp(sqrtGMP, sqrtCPP_GMP) != 0 || mpz_cmp(remGMP, remCPP_GMP) != 0)
+	{
+		std::cerr << "Validation failed: GMP sqrtrem does not match CPPBigInt::BigInt sqrtrem!" << std::endl;
+		valid = false;
+	}
+	// Compare GMP factorial, Fibonacci and Catalan numbers with CPPBigInt's
+	if (mpz_cmp(factGMP, factCPP_GMP) != 0 || mpz_cmp(fibGMP, fibCPP_GMP) != 0 || mpz_cmp(catGMP, catCPP_GMP) != 0)
+	{
+		std::cerr << "Validation failed: GMP factorial/Fibonacci/Catalan does not match CPPBigInt::BigInt!" << std::endl;
+		valid = false;
+	}
+	// Compare GMP modular square with the fixed-width Montgomery product
+	if (mpz_cmp(aLow, mulmodGMP) != 0)
+	{
+		std::cerr << "Validation failed: GMP mulmod does not match CPPBigInt::UMont<256>!" << std::endl;
+		valid = false;
+	}
+	// Compare GMP remainders with CPPBigInt's for several values reduced by
+	// one divisor in a row, which after the first goes through the cached
+	// Barrett context: b, above BARRETT_THRESHOLD on either pair, and its top
+	// 1900 digits (about 100 limbs), below it
+	CPPBigInt::BigInt modValues[4] = {aCPP, prodCPP, prodCPP * prodCPP, sumCPP * aCPP + bCPP};
+	mpz_t modDivisorGMP, modValueGMP, modGMP, modCPP_GMP;
+	mpz_init(modDivisorGMP);
+	mpz_init(modValueGMP);
+	mpz_init(modGMP);
+	mpz_init(modCPP_GMP);
+	for (int d = 0; d < 2; d++)
+	{
+		CPPBigInt::BigInt divisorCPP = d ? CPPBigInt::BigInt(s2.substr(0, 1900)) : bCPP;
+		mpz_set_str(modDivisorGMP, to_string(divisorCPP).c_str(), 10);
+		for (int v = 0; v < 4; v++)
+		{
+			CPPBigInt::BigInt modCPP = modValues[v] % divisorCPP;
+			mpz_set_str(modValueGMP, to_string(modValues[v]).c_str(), 10);
+			mpz_mod(modGMP, modValueGMP, modDivisorGMP);
+			mpz_set_str(modCPP_GMP, to_string(modCPP).c_str(), 10);
+			if (mpz_cmp(modGMP, modCPP_GMP) != 0)
+			{
+				std::cerr << "Validation failed: GMP mod does not match CPPBigInt::BigInt % (divisor " << d << ", value " << v << ")!" << std::endl;
+				valid = false;
+			}
+		}
+	}
+	mpz_clear(modDivisorGMP);
+	mpz_clear(modValueGMP);
+	mpz_clear(modGMP);
+	mpz_clear(modCPP_GMP);
 
 	// Clean up GMP memory
 	mpz_clear(aGMP);
@@ -1141,6 +7206,19 @@ bool testCPP(std::string s1, std::string s2)
 	mpz_clear(prodGMP);
 	mpz_clear(sumCPP_GMP);
 	mpz_clear(prodCPP_GMP);
+	mpz_clear(sqrtGMP);
+	mpz_clear(remGMP);
+	mpz_clear(sqrtCPP_GMP);
+	mpz_clear(remCPP_GMP);
+	mpz_clear(factGMP);
+	mpz_clear(fibGMP);
+	mpz_clear(catGMP);
+	mpz_clear(factCPP_GMP);
+	mpz_clear(fibCPP_GMP);
+	mpz_clear(catCPP_GMP);
+	mpz_clear(aLow);
+	mpz_clear(mLow);
+	mpz_clear(mulmodGMP);
 
 	return valid;
 }
@@ -1174,14 +7252,48 @@ std::string generateRandomBigNumber(size_t length)
 	return number;
 }
 
-int main()
+int main(int argc, char **argv)
 {
-	std::vector<std::pair<std::string, std::string>> tests(1);
-	for (int i = 0; i < 1; i++)
+	// `--tune [file]` measures this host's algorithm cutoffs and writes them
+	// as a header (bigint_tuned.h by default) instead of running the tests
+	if (argc > 1 && !strcmp(argv[1], "--tune"))
+	{
+		const char *path = argc > 2 ? argv[2] : "bigint_tuned.h";
+		FILE *out = fopen(path, "w");
+		if (!out)
+		{
+			std::cerr << "Cannot write " << path << '\n';
+			return 1;
+		}
+		CBigInt::bigint_tune(out);
+		fclose(out);
+		std::cout << "Wrote " << path << '\n';
+		return 0;
+	}
+#if BIGINT_HAVE_MMAP
+	// `--multiply-files a b product [MiB]` multiplies two raw limb files out
+	// of core and reports what the job cost, for sizing larger ones
+	if (argc > 4 && !strcmp(argv[1], "--multiply-files"))
 	{
-		// Generate two big numbers (with 50 digits)
-		tests[i] = {generateRandomBigNumber(5423), generateRandomBigNumber(5345)};
+		size_t memory = argc > 5 ? (size_t)atoll(argv[5]) << 20 : 0;
+		CBigInt::BigIntDiskStats stats;
+		if (CBigInt::bigint_multiply_files(argv[2], argv[3], argv[4], memory, &stats) < 0)
+		{
+			std::cerr << "Cannot multiply " << argv[2] << " by " << argv[3] << ": " << strerror(errno) << '\n';
+			return 1;
+		}
+		std::cout << "Block: " << stats.block << " limbs\n"
+				  << "Peak RSS: " << stats.peak_rss << " bytes\n"
+				  << "Streamed: " << stats.bytes_read << " bytes read, " << stats.bytes_written << " bytes written\n"
+				  << "Storage I/O: " << stats.disk_read << " bytes read, " << stats.disk_written << " bytes written\n";
+		return 0;
 	}
+#endif
+	// Two pairs of big numbers: about 280 limbs, in the Toom-3 range, and
+	// about 2600 limbs, past NTT_THRESHOLD
+	std::vector<std::pair<std::string, std::string>> tests = {
+		{generateRandomBigNumber(5423), generateRandomBigNumber(5345)},
+		{generateRandomBigNumber(50000), generateRandomBigNumber(49000)}};
 	bool C = true, CPP = true;
 	for (auto &[num1, num2] : tests)
 	{
@@ -1270,7 +7382,7 @@ int main()
 }
 /*
 CBigInt: Suitable for very large numbers.
-CPPBigInt: Suitable for small-large numbers and for beginners.
+CPPBigInt: Operator-overloaded C++ wrapper over the CBigInt engine (non-negative values only).
 GMP: For performance and very very large numbers (as it's insanely optimized by algorithms and widely used for big number computation).
 Test for both addition and multiplication of 5423 and 5345 digits number (100% CPU):
 ```
@@ -1282,12 +7394,11 @@ CPPBigInt Benchmark: 516.056 ms
 ```
 Proof:
 ```c++
-	std::vector<std::pair<std::string, std::string>> tests(1);
-	for (int i = 0; i < 1; i++)
-	{
-		// Generate two big numbers (with 50 digits)
-		tests[i] = {generateRandomBigNumber(5423), generateRandomBigNumber(5345)};
-	}
+	// Two pairs of big numbers: about 280 limbs, in the Toom-3 range, and
+	// about 2600 limbs, past NTT_THRESHOLD
+	std::vector<std::pair<std::string, std::string>> tests = {
+		{generateRandomBigNumber(5423), generateRandomBigNumber(5345)},
+		{generateRandomBigNumber(50000), generateRandomBigNumber(49000)}};
 ```
 */
 /*
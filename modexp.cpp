@@ -1,12 +1,14 @@
 // Efficient modular exponentiation (a^b % mod)
+// Products are taken in 128 bits, so any mod below 2^63 works. For
+// multi-limb moduli see CBigInt::bigint_modexp in bigint.cpp.
 long long modExp(long long a, long long b, long long mod) {
     long long result = 1;
     a = a % mod;
     while (b > 0) {
         if (b % 2 == 1) {
-            result = (result * a) % mod;
+            result = (long long)((__int128)result * a % mod);
         }
-        a = (a * a) % mod;
+        a = (long long)((__int128)a * a % mod);
         b /= 2;
     }
     return result;